@@ -1,25 +1,100 @@
 // ConfigService.cpp  -  配置文件读写实现
 #include "ConfigService.h"
+#include "FileOps.h"
 #include "SimpleJson.hpp"
+#include "Logger.h"
+#include "resource.h"
 
 #include <windows.h>
 #include <shlwapi.h>
 #include <fstream>
-#include <sstream>
-#include <random>
-#include <iomanip>
 #include <algorithm>
+#include <iterator>
+#include <functional>
+#include <ctime>
+#include <cstring>
 
 #pragma comment(lib, "shlwapi.lib")
 
+// 日志为宽字符，配置与错误信息为 UTF-8
+static std::wstring utf8ToWide(const std::string& s) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+    std::wstring w(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, w.data(), len);
+    w.resize(wcslen(w.c_str()));
+    return w;
+}
+
 // ─── 单例 ─────────────────────────────────────────────────────────────────────
 ConfigService& ConfigService::instance() {
     static ConfigService inst;
     return inst;
 }
 
-AppConfig& ConfigService::config() { return m_config; }
-const AppConfig& ConfigService::config() const { return m_config; }
+// ─── 配置版本 ─────────────────────────────────────────────────────────────────
+ConfigPtr ConfigService::snapshot() const {
+    return std::atomic_load(&m_snapshot);
+}
+
+void ConfigService::publish(std::shared_ptr<ConfigSnapshot> next) {
+    std::atomic_store(&m_snapshot, ConfigPtr(std::move(next)));
+    requestValidation(false);
+}
+
+std::shared_ptr<ConfigSnapshot> ConfigService::copyCurrent() const {
+    return std::make_shared<ConfigSnapshot>(*m_snapshot);
+}
+
+// ─── 修改配置 ────────────────────────────────────────────────────────────────
+void ConfigService::addProcess(const ProcessConfig& p) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto next = copyCurrent();
+    next->index[p.id] = next->config.processes.size();
+    next->config.processes.push_back(p);
+    publish(std::move(next));
+    journalAdd(p);
+}
+
+bool ConfigService::updateProcess(const ProcessConfig& p) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto it = m_snapshot->index.find(p.id);
+    if (it == m_snapshot->index.end()) return false;
+    auto next = copyCurrent();
+    next->config.processes[it->second] = p;
+    publish(std::move(next));
+    journalUpdate(p);
+    return true;
+}
+
+bool ConfigService::removeProcess(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto it = m_snapshot->index.find(id);
+    if (it == m_snapshot->index.end()) return false;
+    size_t slot = it->second;
+    auto next = copyCurrent();
+    next->index.erase(id);
+    next->config.processes.erase(next->config.processes.begin() + slot);
+    next->reindex(slot);
+    publish(std::move(next));
+    journalDelete(id);
+    return true;
+}
+
+void ConfigService::setAutoStartOnOpen(bool on) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto next = copyCurrent();
+    next->config.autoStartOnOpen = on;
+    publish(std::move(next));
+    journalSettings(m_snapshot->config);
+}
+
+void ConfigService::setLaunchConcurrency(int n) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto next = copyCurrent();
+    next->config.launchConcurrency = n < 0 ? 0 : n;
+    publish(std::move(next));
+    journalSettings(m_snapshot->config);
+}
 
 // ─── 配置文件路径 ─────────────────────────────────────────────────────────────
 std::string ConfigService::configFilePath() const {
@@ -30,120 +105,582 @@ std::string ConfigService::configFilePath() const {
     return path;
 }
 
-// ─── UUID 生成器 ─────────────────────────────────────────────────────────────
+std::string ConfigService::cacheFilePath() const {
+    char path[MAX_PATH] = {};
+    GetModuleFileNameA(nullptr, path, MAX_PATH);
+    PathRemoveFileSpecA(path);
+    PathAppendA(path, "config.cache");
+    return path;
+}
+
+std::string ConfigService::journalFilePath() const {
+    char path[MAX_PATH] = {};
+    GetModuleFileNameA(nullptr, path, MAX_PATH);
+    PathRemoveFileSpecA(path);
+    PathAppendA(path, "config.journal");
+    return path;
+}
+
+// ─── id 与类型（实现在 ConfigTypes.cpp）────────────────────────────────────────
 std::string ConfigService::newId() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<uint32_t> dis;
-    std::ostringstream oss;
-    auto r = [&]() { return dis(gen); };
-    oss << std::hex << std::setfill('0');
-    oss << std::setw(8) << r() << '-';
-    oss << std::setw(4) << (r() & 0xFFFF) << '-';
-    oss << std::setw(4) << ((r() & 0x0FFF) | 0x4000) << '-';
-    oss << std::setw(4) << ((r() & 0x3FFF) | 0x8000) << '-';
-    oss << std::setw(4) << (r() & 0xFFFF);
-    oss << std::setw(8) << r();
-    return oss.str();
-}
-
-// ─── 根据扩展名判断类型 ──────────────────────────────────────────────────────
+    return newProcessId();
+}
+
 std::string ConfigService::typeFromPath(const std::string& path) {
-    auto pos = path.rfind('.');
-    if (pos == std::string::npos) return "exe";
-    std::string ext = path.substr(pos + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    if (ext == "bat" || ext == "cmd") return "bat";
-    return "exe";
+    return processTypeFromPath(path);
+}
+
+// ─── 启动缓存 ────────────────────────────────────────────────────────────────
+namespace {
+
+// 只读映射整个文件；文件不存在或为空时 view() 为空
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return;
+        m_map = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_map) return;
+        m_data = static_cast<const char*>(MapViewOfFile(m_map, FILE_MAP_READ, 0, 0, 0));
+        if (m_data) m_size = (size_t)size.QuadPart;
+    }
+    ~MappedFile() {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_map) CloseHandle(m_map);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool exists() const { return m_file != INVALID_HANDLE_VALUE; }
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+private:
+    HANDLE      m_file = INVALID_HANDLE_VALUE;
+    HANDLE      m_map  = nullptr;
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+};
+
+} // namespace
+
+bool ConfigService::loadCache(const std::string& path, uint64_t sourceHash, AppConfig& cfg) {
+    MappedFile file(path);
+    return ConfigStore::decodeCache(file.view(), sourceHash, cfg);
+}
+
+// 与 config.json 一样先写临时文件再原子替换，写入失败时删除旧缓存，下次启动回退到解析文本
+void ConfigService::writeCache(const std::string& path, uint64_t sourceHash, const AppConfig& cfg) {
+    std::string temp = path + ".tmp";
+    std::string error;
+    if (fileops::writeDurable(temp, ConfigStore::encodeCache(sourceHash, cfg), error) &&
+        fileops::replace(temp, path, error))
+        return;
+    fileops::remove(temp);
+    fileops::remove(path);
+    pmLogF(L"[配置] 启动缓存写入失败  %s", utf8ToWide(error).c_str());
 }
 
 // ─── 加载配置 ────────────────────────────────────────────────────────────────
+// 映射 config.json，内容哈希与 config.cache 匹配时直接解码缓存；否则按 SJ_FIELDS 字段表解析文本并重建缓存，
+// 之后依次重放封存日志与当前日志中尚未并入快照的修改
 bool ConfigService::load() {
-    std::string fpath = configFilePath();
-    std::ifstream ifs(fpath);
-    if (!ifs.is_open()) {
-        // 文件不存在，创建默认配置
-        m_config = AppConfig{};
-        return save();
-    }
-    std::ostringstream ss;
-    ss << ifs.rdbuf();
-    std::string text = ss.str();
-    if (text.empty()) { m_config = AppConfig{}; return true; }
-
-    try {
-        sj::Value root = sj::parse(text);
-        m_config.autoStartOnOpen = root.contains("autoStartOnOpen")
-            ? root["autoStartOnOpen"].get_bool_or(false) : false;
-
-        m_config.processes.clear();
-        if (root.contains("processes") && root["processes"].is_array()) {
-            for (size_t i = 0; i < root["processes"].size(); ++i) {
-                const sj::Value& pv = root["processes"][i];
-                ProcessConfig p;
-                p.id               = pv.contains("id")               ? pv["id"].get_string_or("")      : newId();
-                p.name             = pv.contains("name")             ? pv["name"].get_string_or("")     : "";
-                p.path             = pv.contains("path")             ? pv["path"].get_string_or("")     : "";
-                p.type             = pv.contains("type")             ? pv["type"].get_string_or("exe")  : typeFromPath(p.path);
-                p.args             = pv.contains("args")             ? pv["args"].get_string_or("")     : "";
-                p.delaySeconds     = pv.contains("delaySeconds")     ? pv["delaySeconds"].get_int_or(0) : 0;
-                p.guardEnabled     = pv.contains("guardEnabled")     ? pv["guardEnabled"].get_bool_or(true) : true;
-                p.guardDelaySeconds= pv.contains("guardDelaySeconds")? pv["guardDelaySeconds"].get_int_or(3) : 3;
-                p.enabled          = pv.contains("enabled")          ? pv["enabled"].get_bool_or(true)  : true;
-                p.background       = pv.contains("background")       ? pv["background"].get_bool_or(false) : false;
-                m_config.processes.push_back(std::move(p));
+    auto snap = std::make_shared<ConfigSnapshot>();
+    AppConfig& cfg = snap->config;
+    bool ok = true;
+    bool exists = false;
+    size_t assigned = 0;   // 文件中没有 id 的条目数
+    {
+        MappedFile json(configFilePath());
+        exists = json.exists();
+        std::string_view text = json.view();
+        uint64_t hash = ConfigStore::contentHash(text);
+        bool rebuild = false;
+        if (!text.empty() && !loadCache(cacheFilePath(), hash, cfg)) {
+            ok = ConfigStore::parse(text, cfg);
+            if (ok) {
+                assigned = assignMissingIds(cfg);
+                rebuild = true;
             }
         }
-        return true;
-    } catch (...) {
-        m_config = AppConfig{};
-        return false;
+        std::lock_guard<std::mutex> fileLock(m_fileMutex);
+        m_diskHash = hash;
+        if (rebuild) writeCache(cacheFilePath(), hash, cfg);
     }
+
+    {
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        std::lock_guard<std::mutex> lock(m_journalMutex);
+        snap->reindex();
+        // 快照损坏时日志失去了重放的基准，不重放而改名为 *.bad 保留，供人工合并
+        bool sealed = ok && m_store.hasSealed();
+        size_t bad = 0;
+        size_t n = 0;
+        if (ok) n = m_store.recover(*snap, true, bad);
+        else if (size_t moved = m_store.setAsideJournals())
+            pmLogF(L"[配置] config.json 无法解析，%zu 份增量日志未重放，已改名为 *.bad 保留", moved);
+        if (n) pmLogF(L"[配置] 已从日志恢复 %zu 项修改", n);
+        if (bad) pmLogF(L"[配置] 日志中有 %zu 条记录无法解析，已跳过", bad);
+        publish(std::move(snap));
+        requestValidation(true);
+
+        if (!m_store.openJournal()) pmLog(L"[配置] 无法打开日志文件，修改将整体保存");
+
+        // 补上的 id 写回 config.json，之后重新读取文件时 id 保持不变
+        if (assigned) queueSave();
+
+        // 上次退出前未完成的压缩在后台补做
+        if (exists && sealed) queueSave(true);
+        else if (exists && m_store.journalBytes() >= ConfigStore::kJournalCompactBytes) sealJournal();
+    }
+
+    if (!exists) {
+        // 文件不存在，创建默认配置
+        save();
+        return flush();
+    }
+    return ok;
+}
+
+// ─── JSON 序列化 ─────────────────────────────────────────────────────────────
+// 直接由结构体写出 JSON 文本，不构建中间 Value 树
+std::string ConfigService::processConfigToJson(const ProcessConfig& p) {
+    return sj::encode(p, true);
+}
+
+std::string ConfigService::appConfigToJson(const AppConfig& cfg) {
+    return sj::encode(cfg, true);
 }
 
 // ─── 保存配置 ────────────────────────────────────────────────────────────────
+// config.json 供人工查看和编辑，保持带缩进的格式
 bool ConfigService::save() {
-    std::string json = appConfigToJson(m_config);
-    std::ofstream ofs(configFilePath());
-    if (!ofs.is_open()) return false;
-    ofs << json;
+    queueSave();
     return true;
 }
 
-// ─── JSON 序列化 ─────────────────────────────────────────────────────────────
-std::string ConfigService::processConfigToJson(const ProcessConfig& p) {
-    sj::Object obj;
-    obj["id"]               = p.id;
-    obj["name"]             = p.name;
-    obj["path"]             = p.path;
-    obj["type"]             = p.type;
-    obj["args"]             = p.args;
-    obj["delaySeconds"]     = p.delaySeconds;
-    obj["guardEnabled"]     = p.guardEnabled;
-    obj["guardDelaySeconds"]= p.guardDelaySeconds;
-    obj["enabled"]          = p.enabled;
-    obj["background"]       = p.background;
-    return sj::stringify(sj::Value(obj));
+uint64_t ConfigService::queueSave(bool seal) {
+    ConfigPtr snap = snapshot();
+    std::string buf;
+    sj::Writer w(buf, true);
+    sj::encode(w, snap->config);
+
+    std::lock_guard<std::mutex> lock(m_saveMutex);
+    m_pending.swap(buf);
+    m_pendingSnap = std::move(snap);
+    m_pendingSeq = ++m_saveSeq;
+    if (seal) m_sealedSeq = m_pendingSeq;
+    m_dirty = true;
+    m_dueAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(kSaveDebounceMs);
+    if (!m_writer.joinable()) m_writer = std::thread(&ConfigService::writerLoop, this);
+    m_saveCv.notify_one();
+    return m_pendingSeq;
 }
 
-std::string ConfigService::appConfigToJson(const AppConfig& cfg) {
-    sj::Object root;
-    root["autoStartOnOpen"] = cfg.autoStartOnOpen;
-    sj::Array arr;
-    for (const auto& p : cfg.processes) {
-        sj::Object obj;
-        obj["id"]               = p.id;
-        obj["name"]             = p.name;
-        obj["path"]             = p.path;
-        obj["type"]             = p.type;
-        obj["args"]             = p.args;
-        obj["delaySeconds"]     = p.delaySeconds;
-        obj["guardEnabled"]     = p.guardEnabled;
-        obj["guardDelaySeconds"]= p.guardDelaySeconds;
-        obj["enabled"]          = p.enabled;
-        obj["background"]       = p.background;
-        arr.push_back(sj::Value(obj));
-    }
-    root["processes"] = arr;
-    return sj::stringify(sj::Value(root));
+bool ConfigService::flush() {
+    // 持有日志锁直到快照落盘，期间不会有新的记录写入即将清空的日志
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    const bool merge = m_store.journalBytes() > 0 || m_sealedSeq != 0;
+    if (merge) queueSave(true);
+
+    std::unique_lock<std::mutex> lock(m_saveMutex);
+    // 先取文件锁再放开待写状态：若后台线程正在写入较旧的内容，等它完成后再写新的
+    std::unique_lock<std::mutex> fileLock(m_fileMutex);
+    if (!m_dirty) return true;
+    std::string data;
+    data.swap(m_pending);
+    ConfigPtr snap = std::move(m_pendingSnap);
+    uint64_t seq = m_pendingSeq;
+    m_dirty = false;
+    lock.unlock();
+    if (!writeSnapshot(data, snap->config, seq)) return false;
+
+    // 快照已包含全部修改，清空当前日志
+    if (merge) m_store.truncateJournal();
+    return true;
+}
+
+ConfigService::~ConfigService() {
+    stopValidation();
+    stopWatching();
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        m_stop = true;
+    }
+    m_saveCv.notify_one();
+    if (m_writer.joinable()) m_writer.join();
+}
+
+void ConfigService::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_saveMutex);
+    for (;;) {
+        m_saveCv.wait(lock, [this] { return m_dirty || m_stop; });
+        // 去抖：每次 save() 都会推迟截止时间，直到一段时间内不再有修改
+        while (m_dirty && !m_stop && std::chrono::steady_clock::now() < m_dueAt)
+            m_saveCv.wait_until(lock, m_dueAt);
+        if (m_stop) return;          // 退出时由 flush() 负责写入剩余内容
+        if (!m_dirty) continue;      // 已被 flush() 写入
+
+        std::string data;
+        data.swap(m_pending);
+        ConfigPtr snap = std::move(m_pendingSnap);
+        uint64_t seq = m_pendingSeq;
+        m_dirty = false;
+        std::unique_lock<std::mutex> fileLock(m_fileMutex);
+        lock.unlock();
+        writeSnapshot(data, snap->config, seq);
+        fileLock.unlock();
+        lock.lock();
+    }
+}
+
+bool ConfigService::writeSnapshot(const std::string& data, const AppConfig& cfg, uint64_t seq) {
+    if (!writeFileAtomic(data)) return false;
+    writeCache(cacheFilePath(), m_diskHash, cfg);
+    uint64_t sealed = m_sealedSeq;
+    if (sealed != 0 && seq >= sealed && m_store.removeSealed()) m_sealedSeq = 0;
+    return true;
+}
+
+bool ConfigService::writeFileAtomic(const std::string& data) {
+    std::string error;
+    if (!m_store.writeTemp(data, error)) {
+        pmLogF(L"[配置] 保存失败  %s", utf8ToWide(error).c_str());
+        return false;
+    }
+    // 先记下哈希再替换：监视线程随后看到的改写即可识别为本进程所为
+    uint64_t prev = m_diskHash;
+    m_diskHash = ConfigStore::contentHash(data);
+    if (!m_store.replaceConfig(error)) {
+        m_diskHash = prev;
+        pmLogF(L"[配置] 保存失败  %s", utf8ToWide(error).c_str());
+        return false;
+    }
+    return true;
+}
+
+// ─── 增量日志 ────────────────────────────────────────────────────────────────
+void ConfigService::journalAdd(const ProcessConfig& p) {
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    afterAppend(m_store.appendAdd(p));
+}
+
+void ConfigService::journalUpdate(const ProcessConfig& p) {
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    afterAppend(m_store.appendUpdate(p));
+}
+
+void ConfigService::journalDelete(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    afterAppend(m_store.appendDelete(id));
+}
+
+void ConfigService::journalSettings(const AppConfig& cfg) {
+    std::lock_guard<std::mutex> lock(m_journalMutex);
+    afterAppend(m_store.appendSettings(cfg));
+}
+
+void ConfigService::afterAppend(bool appended) {
+    if (!appended) {
+        queueSave();   // 日志不可用时退回整体保存
+        return;
+    }
+    if (m_store.journalBytes() >= ConfigStore::kJournalCompactBytes && m_sealedSeq == 0) sealJournal();
+}
+
+// 当前日志改名为 config.journal.old，另起一份空日志，并排入覆盖封存内容的快照
+bool ConfigService::sealJournal() {
+    std::string error;
+    if (!m_store.seal(error)) {
+        pmLogF(L"[配置] 日志压缩失败  %s", utf8ToWide(error).c_str());
+        return false;
+    }
+    queueSave(true);
+    return true;
+}
+
+// ─── 热重载 ──────────────────────────────────────────────────────────────────
+void ConfigService::startWatching(HWND hwnd) {
+    if (m_watcher.joinable()) return;
+    char dir[MAX_PATH] = {};
+    GetModuleFileNameA(nullptr, dir, MAX_PATH);
+    PathRemoveFileSpecA(dir);
+    m_watchDir = CreateFileA(dir, FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_watchDir == INVALID_HANDLE_VALUE) {
+        pmLogF(L"[配置] 无法监视配置目录  错误码=%lu", GetLastError());
+        return;
+    }
+    m_watchStop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_watcher = std::thread(&ConfigService::watchLoop, this, hwnd);
+}
+
+void ConfigService::stopWatching() {
+    if (!m_watcher.joinable()) return;
+    SetEvent(m_watchStop);
+    m_watcher.join();
+    CloseHandle(m_watchStop);
+    CloseHandle(m_watchDir);
+    m_watchStop = nullptr;
+    m_watchDir  = INVALID_HANDLE_VALUE;
+}
+
+void ConfigService::watchLoop(HWND hwnd) {
+    alignas(DWORD) char buf[4096];
+    OVERLAPPED ov = {};
+    ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    HANDLE waits[2] = { m_watchStop, ov.hEvent };
+
+    for (;;) {
+        ResetEvent(ov.hEvent);
+        if (!ReadDirectoryChangesW(m_watchDir, buf, sizeof(buf), FALSE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                nullptr, &ov, nullptr)) {
+            pmLogF(L"[配置] 监视配置目录失败  错误码=%lu", GetLastError());
+            break;
+        }
+        DWORD bytes = 0;
+        if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+            CancelIoEx(m_watchDir, &ov);
+            GetOverlappedResult(m_watchDir, &ov, &bytes, TRUE);
+            break;
+        }
+        if (!GetOverlappedResult(m_watchDir, &ov, &bytes, FALSE)) break;
+
+        // bytes 为 0 表示通知缓冲区溢出，无法得知具体文件，保守地当作 config.json 有变化
+        bool hit = bytes == 0;
+        for (DWORD off = 0; !hit && bytes != 0;) {
+            auto* fni = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buf + off);
+            hit = CompareStringOrdinal(fni->FileName, (int)(fni->FileNameLength / sizeof(WCHAR)),
+                                       L"config.json", -1, TRUE) == CSTR_EQUAL;
+            if (!fni->NextEntryOffset) break;
+            off += fni->NextEntryOffset;
+        }
+        if (hit) PostMessage(hwnd, WM_APP_CONFIG_CHANGED, 0, 0);
+    }
+    CloseHandle(ov.hEvent);
+}
+
+bool ConfigService::reload(ConfigDiff& diff) {
+    size_t assigned = 0;   // 文件中没有 id 的条目数
+    bool changed = false;
+    {
+        // 按全局顺序取全部锁：读取期间后台写入不能落盘，也不能有新的修改或日志
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        std::lock_guard<std::mutex> journalLock(m_journalMutex);
+        std::lock_guard<std::mutex> saveLock(m_saveMutex);
+        std::lock_guard<std::mutex> fileLock(m_fileMutex);
+
+        std::string text;
+        {
+            std::ifstream ifs(configFilePath(), std::ios::binary);
+            if (!ifs.is_open()) return false;
+            text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+        uint64_t hash = ConfigStore::contentHash(text);
+        if (hash == m_diskHash) return false;
+
+        // 编辑器保存过程中可能读到空文件或半截内容，解析失败时等待下一次通知
+        auto next = std::make_shared<ConfigSnapshot>();
+        try { sj::decode(text, next->config); } catch (...) { return false; }
+        assigned = assignMissingIds(next->config, m_snapshot.get());
+        next->reindex();
+        m_diskHash = hash;
+        writeCache(cacheFilePath(), hash, next->config);
+
+        changed = diffConfig(*m_snapshot, *next, diff);
+        if (changed) {
+            // 文件即新的基准：丢弃尚未落盘的旧快照与日志，否则之后会覆盖或重放到外部修改之上
+            m_dirty = false;
+            m_pending.clear();
+            m_pendingSnap.reset();
+            m_sealedSeq = 0;
+            m_store.discardJournals();
+
+            publish(std::move(next));
+            requestValidation(true);
+            pmLogF(L"[配置] config.json 已被外部修改  新增 %zu  删除 %zu  需重启 %zu",
+                   diff.added.size(), diff.removed.size(), diff.relaunch.size());
+        }
+    }
+    // 补上的 id 写回文件，之后再读取时不必再靠名称与位置对应
+    if (assigned) queueSave();
+    return changed;
+}
+
+// ─── 配置校验 ────────────────────────────────────────────────────────────────
+ValidationPtr ConfigService::validation() const {
+    return std::atomic_load(&m_validation);
+}
+
+void ConfigService::startValidation(HWND hwnd) {
+    if (m_validator.joinable()) return;
+    m_validateStop = false;
+    m_validator = std::thread(&ConfigService::validateLoop, this, hwnd);
+}
+
+void ConfigService::stopValidation() {
+    if (!m_validator.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_validateMutex);
+        m_validateStop = true;
+    }
+    m_validateCv.notify_one();
+    m_validator.join();
+}
+
+void ConfigService::revalidate() { requestValidation(true); }
+
+void ConfigService::requestValidation(bool full) {
+    {
+        std::lock_guard<std::mutex> lock(m_validateMutex);
+        m_validateDirty = true;
+        m_validateFull |= full;
+    }
+    m_validateCv.notify_one();
+}
+
+static bool sameIssues(const ConfigValidation& a, const ConfigValidation& b) {
+    if (a.issues.size() != b.issues.size()) return false;
+    for (const auto& [id, issue] : a.issues) {
+        auto it = b.issues.find(id);
+        if (it == b.issues.end() || it->second.path != issue.path ||
+            it->second.message != issue.message || it->second.configError != issue.configError)
+            return false;
+    }
+    return true;
+}
+
+void ConfigService::validateLoop(HWND hwnd) {
+    PathChecks known;   // 仅由本线程访问
+    std::unique_lock<std::mutex> lock(m_validateMutex);
+    for (;;) {
+        // 没有请求时定期醒来，补查过期的路径
+        bool requested = m_validateCv.wait_for(lock, kPathCheckTtl,
+                                               [this] { return m_validateDirty || m_validateStop; });
+        if (m_validateStop) return;
+        bool full = m_validateFull;
+        m_validateDirty = false;
+        m_validateFull  = false;
+        lock.unlock();
+
+        // 检查期间的修改会再次置位 m_validateDirty，下一轮以最新版本补查
+        if (full) known.clear();
+        ConfigPtr snap = snapshot();
+        auto t0 = std::chrono::steady_clock::now();
+        auto result = std::make_shared<ConfigValidation>(validate(*snap, known, m_checkPool));
+        if (full) {
+            long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+            for (const auto& [id, issue] : result->issues)
+                pmLogF(L"[配置] %-20S  校验未通过：%s", id.c_str(), utf8ToWide(issue.message).c_str());
+            pmLogF(L"[配置] 校验完成  共 %zu 项  未通过 %zu 项  耗时 %lld ms",
+                   snap->config.processes.size(), result->issues.size(), ms);
+        } else if (!requested) {
+            // 定期补查：结果不变时不打扰界面
+            if (sameIssues(*validation(), *result)) {
+                lock.lock();
+                continue;
+            }
+            pmLogF(L"[配置] 定期校验发现变化  未通过 %zu 项", result->issues.size());
+        }
+        std::atomic_store(&m_validation, ValidationPtr(std::move(result)));
+        if (hwnd) PostMessage(hwnd, WM_APP_CONFIG_VALIDATED, 0, 0);
+
+        lock.lock();
+    }
+}
+
+ConfigValidation ConfigService::validate(const ConfigSnapshot& snap, PathChecks& known, LaunchPool& pool) {
+    const auto& procs = snap.config.processes;
+    const auto now = std::chrono::steady_clock::now();
+
+    // 许多条目共用同一个程序，按路径去重；之前已有且未过期的结果直接沿用
+    PathChecks results;
+    std::vector<std::pair<const std::string, PathCheck>*> todo;
+    results.reserve(procs.size());
+    for (const auto& p : procs) {
+        auto [it, inserted] = results.try_emplace(p.path);
+        if (!inserted) continue;
+        auto old = known.find(p.path);
+        if (old != known.end() && now - old->second.at < kPathCheckTtl) it->second = std::move(old->second);
+        else todo.push_back(&*it);
+    }
+
+    // 各任务只写入互不相同的元素，不改变容器结构
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < todo.size();)
+            todo[i]->second = { checkPath(todo[i]->first), std::chrono::steady_clock::now() };
+    };
+    size_t helpers = std::min(kValidateThreads, todo.size());
+    helpers = helpers ? helpers - 1 : 0;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    size_t done = 0;
+    for (size_t n = 0; n < helpers; ++n) {
+        pool.submit(0, [&] {
+            work();
+            std::lock_guard<std::mutex> g(doneMutex);
+            ++done;
+            doneCv.notify_one();
+        });
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> g(doneMutex);
+        doneCv.wait(g, [&] { return done == helpers; });
+    }
+
+    ConfigValidation v;
+    // 索引按 id 去重，条目数多于索引项即存在重复 id
+    std::unordered_map<std::string, size_t> counts;
+    if (snap.index.size() != procs.size())
+        for (const auto& p : procs) ++counts[p.id];
+    for (const auto& p : procs) {
+        auto c = counts.find(p.id);
+        if (c != counts.end() && c->second > 1) {
+            v.issues[p.id] = { p.path, "id 重复（共 " + std::to_string(c->second) + " 项）", true };
+            continue;
+        }
+        if (std::string rule = checkRestartRule(p); !rule.empty()) {
+            v.issues[p.id] = { p.path, std::move(rule), true };
+            continue;
+        }
+        const std::string& msg = results[p.path].message;
+        if (!msg.empty()) v.issues[p.id] = { p.path, msg, false };
+    }
+    known = std::move(results);
+    return v;
+}
+
+std::string ConfigService::checkPath(const std::string& path) {
+    if (path.empty()) return "未设置程序路径";
+    std::wstring wpath = utf8ToWide(path);
+
+    // 不含目录的文件名由 CreateProcess 按系统搜索顺序查找
+    if (wpath.find_first_of(L"\\/") == std::wstring::npos) {
+        if (SearchPathW(nullptr, wpath.c_str(), nullptr, 0, nullptr, nullptr)) return {};
+        return "在系统搜索路径中找不到该程序";
+    }
+
+    DWORD attr = GetFileAttributesW(wpath.c_str());
+    if (attr == INVALID_FILE_ATTRIBUTES) {
+        DWORD err = GetLastError();
+        switch (err) {
+        case ERROR_FILE_NOT_FOUND: return "文件不存在";
+        case ERROR_PATH_NOT_FOUND: return "所在目录不存在";
+        case ERROR_BAD_NETPATH:
+        case ERROR_BAD_NET_NAME:   return "网络路径不可达";
+        case ERROR_ACCESS_DENIED:  return "没有访问权限";
+        default:                   return "无法访问（错误码 " + std::to_string(err) + "）";
+        }
+    }
+    if (attr & FILE_ATTRIBUTE_DIRECTORY) return "路径指向的是目录";
+    return {};
 }
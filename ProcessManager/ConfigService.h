@@ -1,27 +1,20 @@
 // ConfigService.h  -  配置文件读写服务
 #pragma once
+#include <windows.h>
 #include <string>
 #include <vector>
-
-// ─── 数据结构 ─────────────────────────────────────────────────────────────────
-
-struct ProcessConfig {
-    std::string id;
-    std::string name;
-    std::string path;
-    std::string type;          // "exe" 或 "bat"
-    std::string args;
-    int         delaySeconds      = 0;
-    bool        guardEnabled      = true;
-    int         guardDelaySeconds = 1;
-    bool        enabled           = true;
-    bool        background        = false; // 后台进程：启动时不创建控制台窗口
-};
-
-struct AppConfig {
-    bool                       autoStartOnOpen = false;
-    std::vector<ProcessConfig> processes;
-};
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+#include "ConfigTypes.h"
+#include "ConfigStore.h"
+#include "LaunchPool.h"
 
 // ─── 服务类 ───────────────────────────────────────────────────────────────────
 
@@ -29,19 +22,61 @@ class ConfigService {
 public:
     static ConfigService& instance();
 
-    // 加载 config.json；不存在时自动创建默认配置
+    // 加载 config.json 并重放 config.journal 中尚未并入快照的修改；不存在时自动创建默认配置
     bool load();
 
-    // 将当前配置保存到 config.json
+    // 将当前配置排入后台写入：kSaveDebounceMs 内的连续修改合并为一次落盘。
+    // 序列化在调用线程完成，之后对配置的修改不影响本次写入
     bool save();
 
-    AppConfig& config();
-    const AppConfig& config() const;
+    // 立即将尚未落盘的配置写入 config.json 并等待完成（退出前调用）。
+    // 同时把日志并入快照，正常退出后目录中只剩 config.json，可直接手工编辑
+    bool flush();
+
+    ~ConfigService();
+
+    // 当前配置版本，任意线程可调用，只做一次原子读取、不会阻塞。
+    // 持有期间看到的始终是同一个完整版本，不受之后修改的影响
+    ConfigPtr snapshot() const;
+
+    // ─── 修改配置 ───
+    // 各接口复制当前版本、应用修改后原子发布新版本，再向 config.journal 追加一行记录。
+    // 写入方之间由 m_writeMutex 串行化；不存在的 id 返回 false
+    void addProcess(const ProcessConfig& p);
+    bool updateProcess(const ProcessConfig& p);     // 按 p.id 整体替换
+    bool removeProcess(const std::string& id);
+    void setAutoStartOnOpen(bool on);
+    void setLaunchConcurrency(int n);
 
-    // 生成类 UUID 的唯一 id
+    // ─── 热重载 ───
+    // 后台线程监视 exe 目录，config.json 被改写时向 hwnd 投递 WM_APP_CONFIG_CHANGED，
+    // 由 UI 线程去抖 kReloadDebounceMs 后调用 reload()
+    static constexpr int kReloadDebounceMs = 300;
+    void startWatching(HWND hwnd);
+    void stopWatching();
+
+    // 重新读取 config.json 并以其内容发布新版本，尚未落盘的修改与日志一并作废。
+    // 文件中没有 id 的条目沿用当前版本中对应条目的 id（见 assignMissingIds），补上的 id 随后写回文件。
+    // 内容是本进程自己写出的、与当前版本相同或无法解析时返回 false
+    bool reload(ConfigDiff& diff);
+
+    // ─── 配置校验 ───
+    // 后台线程并行检查各条目的 exe / bat 文件及其所在的工作目录是否可访问，并标记重复的 id。
+    // 加载与热重载后完整检查一次，其余修改只检查新出现的路径；没有修改时每隔 kPathCheckTtl
+    // 重新检查结果已过期的路径，程序文件被删除或补齐后无需改动配置也能反映出来。
+    // 每次结果有变化（或由请求触发）后向 hwnd 投递 WM_APP_CONFIG_VALIDATED
+    void startValidation(HWND hwnd);
+    void stopValidation();
+    void revalidate();                 // 丢弃已有结果，完整检查一次
+    ValidationPtr validation() const;  // 最近一次校验结果，任意线程可调用
+
+    // 检查单个路径，返回问题描述，可访问时返回空串。可能在网络路径上阻塞，不要在 UI 线程批量调用
+    static std::string checkPath(const std::string& path);
+
+    // 生成类 UUID 的唯一 id，即 newProcessId()
     static std::string newId();
 
-    // 根据文件扩展名判断进程类型
+    // 根据文件扩展名判断进程类型，即 processTypeFromPath()
     static std::string typeFromPath(const std::string& path);
 
     // JSON 序列化辅助函数（供 MessageRouter 调用）
@@ -50,6 +85,98 @@ public:
 
 private:
     ConfigService() = default;
-    AppConfig  m_config;
     std::string configFilePath() const;
+
+    // ─── 配置版本 ───
+    // 读写一律经 std::atomic_load / atomic_store，旧版本在最后一个读者释放后销毁
+    void publish(std::shared_ptr<ConfigSnapshot> next);
+    std::shared_ptr<ConfigSnapshot> copyCurrent() const;   // 调用方须持有 m_writeMutex
+
+    ConfigPtr  m_snapshot = std::make_shared<ConfigSnapshot>();
+    std::mutex m_writeMutex;   // 串行化写入方；先于 m_journalMutex 获取
+    std::string journalFilePath() const;
+
+    // ─── 后台保存 ───
+    static constexpr int kSaveDebounceMs = 300;
+
+    // 序列化当前配置版本并排入后台写入，返回本次快照的序号；
+    // seal 为 true 时该快照落盘后删除 config.journal.old
+    uint64_t queueSave(bool seal = false);
+    void writerLoop();
+    // 写出快照及其启动缓存；快照不早于封存日志时删除 config.journal.old
+    bool writeSnapshot(const std::string& data, const AppConfig& cfg, uint64_t seq);
+    // 经 m_store 写入临时文件、刷盘后原子替换 config.json，任何时刻磁盘上都是完整的旧文件或新文件
+    bool writeFileAtomic(const std::string& data);
+
+    std::mutex              m_saveMutex;   // 保护以下待写状态；与 m_fileMutex 同时持有时须先取本锁
+    std::condition_variable m_saveCv;
+    std::string             m_pending;     // 最新一次 save() 的序列化结果
+    ConfigPtr               m_pendingSnap; // m_pending 对应的配置版本，用于生成启动缓存
+    uint64_t                m_pendingSeq = 0;
+    uint64_t                m_saveSeq    = 0;
+    bool                    m_dirty = false;
+    bool                    m_stop  = false;
+    std::chrono::steady_clock::time_point m_dueAt;
+    std::thread             m_writer;
+    std::mutex              m_fileMutex;   // 串行化实际的文件写入，保证按 save() 的先后顺序落盘
+    uint64_t                m_diskHash = 0; // config.json 最近一次由本进程读取或写出的内容哈希，受 m_fileMutex 保护
+
+    // ─── 启动缓存 ───
+    // config.cache 的格式见 ConfigStore::encodeCache，以 config.json 的内容哈希为键。
+    // 启动时哈希一致即映射缓存直接解码，省去 JSON 文本解析；不一致或损坏时回退到解析并重新生成
+    std::string cacheFilePath() const;
+    static bool loadCache(const std::string& path, uint64_t sourceHash, AppConfig& cfg);
+    // 经临时文件原子替换，调用方须持有 m_fileMutex
+    static void writeCache(const std::string& path, uint64_t sourceHash, const AppConfig& cfg);
+
+    // ─── 增量日志 ───
+    // 每行一条紧凑 JSON 记录，携带修改后的完整进程对象，格式与重放见 ConfigStore。
+    // 封存的 config.journal.old 在序号不小于 m_sealedSeq 的快照落盘后删除
+    void journalAdd(const ProcessConfig& p);
+    void journalUpdate(const ProcessConfig& p);
+    void journalDelete(const std::string& id);
+    void journalSettings(const AppConfig& cfg);
+
+    // 调用方须持有 m_journalMutex
+    void afterAppend(bool appended);   // 日志不可用时整体保存，过大时封存
+    bool sealJournal();
+
+    // 文件的写入顺序与崩溃后的恢复。日志部分受 m_journalMutex 保护，快照部分受 m_fileMutex 保护
+    ConfigStore           m_store{ configFilePath(), journalFilePath() };
+    std::mutex            m_journalMutex;  // 保护 m_store 的日志状态；先于 m_saveMutex 获取
+    std::atomic<uint64_t> m_sealedSeq{0};  // 0 表示没有等待删除的封存日志
+
+    // ─── 热重载 ───
+    void watchLoop(HWND hwnd);
+
+    HANDLE      m_watchDir  = INVALID_HANDLE_VALUE;   // 以 FILE_FLAG_OVERLAPPED 打开的 exe 目录
+    HANDLE      m_watchStop = nullptr;                // 置位后监视线程退出
+    std::thread m_watcher;
+
+    // ─── 配置校验 ───
+    // 检查以等待文件系统为主，线程数不受核数限制；同一路径在一轮中只检查一次
+    static constexpr size_t kValidateThreads = 16;
+    // 路径检查结果的有效期，也是没有校验请求时校验线程醒来补查的间隔
+    static constexpr std::chrono::seconds kPathCheckTtl{ 60 };
+
+    struct PathCheck {
+        std::string                           message;   // 空串表示通过
+        std::chrono::steady_clock::time_point at;        // 检查时间
+    };
+    using PathChecks = std::unordered_map<std::string, PathCheck>;
+
+    void requestValidation(bool full);
+    void validateLoop(HWND hwnd);
+    // 检查 snap 的全部条目。known 为之前各路径的结果，未过期的不再重复检查；返回时替换为本轮结果。
+    // 检查任务分给 pool 中常驻的线程，当前线程也参与
+    static ConfigValidation validate(const ConfigSnapshot& snap, PathChecks& known, LaunchPool& pool);
+
+    ValidationPtr           m_validation = std::make_shared<ConfigValidation>();
+    std::mutex              m_validateMutex;   // 保护以下请求状态；最后获取，持有期间不取其他锁
+    std::condition_variable m_validateCv;
+    bool                    m_validateDirty = false;
+    bool                    m_validateFull  = false;
+    bool                    m_validateStop  = false;
+    LaunchPool              m_checkPool{ (unsigned)kValidateThreads - 1 };   // 各轮复用，空闲线程保留
+    std::thread             m_validator;
 };
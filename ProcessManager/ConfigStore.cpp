@@ -0,0 +1,338 @@
+// ConfigStore.cpp  -  config.json 与增量日志的落盘与恢复
+#include "ConfigStore.h"
+#include "FileOps.h"
+#include "SimpleMsgPack.hpp"
+
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+// 缓存文件头
+struct CacheHeader {
+    char     magic[4];     // "PMC2"
+    uint32_t schema;       // 字段表指纹，增删、改名或调整成员顺序后旧缓存自动失效
+    uint64_t sourceHash;   // 对应 config.json 的内容哈希
+    uint64_t bodyHash;     // MessagePack 正文的哈希，写到一半的缓存不会被采用
+    uint64_t bodySize;
+};
+static_assert(sizeof(CacheHeader) == 32, "CacheHeader layout");
+
+// PMC1 的正文为以成员名为键的 map，已改为按位置编码
+constexpr char kCacheMagic[4] = { 'P', 'M', 'C', '2' };
+
+template <class T>
+void hashFieldNames(uint64_t& h) {
+    std::apply([&](const auto&... f) {
+        ((h = (h ^ std::hash<std::string_view>{}(f.name)) * 1099511628211ull), ...);
+    }, sj::detail::fieldsOf<T>());
+}
+
+uint32_t cacheSchema() {
+    uint64_t h = 14695981039346656037ull;
+    hashFieldNames<AppConfig>(h);
+    hashFieldNames<ProcessConfig>(h);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+} // namespace
+
+ConfigStore::ConfigStore(std::string configPath, std::string journalPath)
+    : m_configPath(std::move(configPath)),
+      m_tempPath(m_configPath + ".tmp"),
+      m_journalPath(std::move(journalPath)),
+      m_sealedPath(m_journalPath + ".old") {}
+
+// ─── 恢复 ────────────────────────────────────────────────────────────────────
+bool ConfigStore::parse(std::string_view text, AppConfig& cfg) {
+    try {
+        sj::Reader r(text);
+        sj::decode(r, cfg);
+        if (r.next() != sj::Event::End) throw std::runtime_error("Trailing data");
+        return true;
+    } catch (...) {
+        cfg = AppConfig{};
+        return false;
+    }
+}
+
+bool ConfigStore::load(ConfigSnapshot& snap) {
+    std::string text;
+    {
+        std::ifstream ifs(m_configPath, std::ios::binary);
+        if (ifs.is_open()) text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    bool ok = text.empty() || parse(text, snap.config);
+    if (ok) assignMissingIds(snap.config);
+    snap.reindex();
+    size_t bad = 0;
+    recover(snap, ok, bad);
+    return ok;
+}
+
+size_t ConfigStore::recover(ConfigSnapshot& snap, bool parsed, size_t& bad) {
+    if (!parsed) {
+        setAsideJournals();
+        return 0;
+    }
+    // 封存日志早于当前日志，按顺序重放
+    return replayJournal(m_sealedPath, snap, bad) + replayJournal(m_journalPath, snap, bad);
+}
+
+size_t ConfigStore::setAsideJournals() {
+    size_t moved = 0;
+    std::string error;
+    for (const std::string* path : { &m_sealedPath, &m_journalPath }) {
+        if (fileops::exists(*path) && fileops::replace(*path, *path + ".bad", error)) ++moved;
+    }
+    return moved;
+}
+
+bool ConfigStore::hasSealed() const {
+    return fileops::exists(m_sealedPath);
+}
+
+// ─── 启动缓存 ────────────────────────────────────────────────────────────────
+uint64_t ConfigStore::contentHash(std::string_view data) {
+    uint64_t h = 14695981039346656037ull ^ data.size();
+    const char* p = data.data();
+    size_t n = data.size();
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        h = (h ^ w) * 1099511628211ull;
+        h ^= h >> 29;
+    }
+    for (; n; ++p, --n) h = (h ^ (unsigned char)*p) * 1099511628211ull;
+    return h;
+}
+
+std::string ConfigStore::encodeCache(uint64_t sourceHash, const AppConfig& cfg) {
+    std::string buf(sizeof(CacheHeader), '\0');
+    sj::msgpack::Packer pk(buf);
+    sj::msgpack::encodeTuple(pk, cfg);
+    std::string_view body = std::string_view(buf).substr(sizeof(CacheHeader));
+
+    CacheHeader hdr;
+    std::memcpy(hdr.magic, kCacheMagic, sizeof(kCacheMagic));
+    hdr.schema     = cacheSchema();
+    hdr.sourceHash = sourceHash;
+    hdr.bodyHash   = contentHash(body);
+    hdr.bodySize   = body.size();
+    std::memcpy(&buf[0], &hdr, sizeof(hdr));
+    return buf;
+}
+
+bool ConfigStore::decodeCache(std::string_view bytes, uint64_t sourceHash, AppConfig& cfg) {
+    CacheHeader hdr;
+    if (bytes.size() < sizeof(hdr)) return false;
+    std::memcpy(&hdr, bytes.data(), sizeof(hdr));
+    std::string_view body = bytes.substr(sizeof(hdr));
+    if (std::memcmp(hdr.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        hdr.schema != cacheSchema() || hdr.sourceHash != sourceHash ||
+        hdr.bodySize != body.size() || hdr.bodyHash != contentHash(body))
+        return false;
+    try {
+        AppConfig c;
+        sj::msgpack::decodeTuple(body, c);
+        cfg = std::move(c);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// ─── 快照 ────────────────────────────────────────────────────────────────────
+bool ConfigStore::writeTemp(const std::string& data, std::string& error) {
+    if (fileops::writeDurable(m_tempPath, data, error)) return true;
+    fileops::remove(m_tempPath);
+    return false;
+}
+
+bool ConfigStore::replaceConfig(std::string& error) {
+    if (fileops::replace(m_tempPath, m_configPath, error)) return true;
+    fileops::remove(m_tempPath);
+    return false;
+}
+
+// ─── 增量日志 ────────────────────────────────────────────────────────────────
+namespace {
+
+// 日志记录的解码视图；写出时只输出与 op 相关的字段
+struct JournalRecord {
+    std::string   op;
+    ProcessConfig process;
+    std::string   id;
+    bool          autoStartOnOpen   = false;
+    int           launchConcurrency = 0;
+};
+
+SJ_FIELDS(JournalRecord, op, process, id, autoStartOnOpen, launchConcurrency)
+
+// 写出记录的公共头部；time 为 Unix 秒，仅供查阅修改历史，重放时忽略
+sj::Writer& recordHead(sj::Writer& w, const char* op) {
+    return w.startObject()
+            .key("op").value(op)
+            .key("time").value((long long)std::time(nullptr));
+}
+
+} // namespace
+
+bool ConfigStore::openJournal() {
+    bool torn = false;
+    {
+        std::ifstream in(m_journalPath, std::ios::binary | std::ios::ate);
+        if (in.is_open() && in.tellg() > 0) {
+            in.seekg(-1, std::ios::end);
+            torn = in.get() != '\n';
+        }
+    }
+    m_journal.close();
+    m_journal.clear();
+    m_journal.open(m_journalPath, std::ios::binary | std::ios::app);
+    m_journal.seekp(0, std::ios::end);
+    m_journalBytes = m_journal ? (uint64_t)m_journal.tellp() : 0;
+    if (!m_journal.is_open()) return false;
+    if (torn) {
+        // 半截的行在重放时被跳过；不补换行的话下一条记录会接在它后面一起作废
+        m_journal.put('\n');
+        m_journal.flush();
+        ++m_journalBytes;
+    }
+    return true;
+}
+
+bool ConfigStore::appendProcess(const char* op, const ProcessConfig& p) {
+    m_buf.clear();
+    sj::Writer w(m_buf);
+    recordHead(w, op).key("process");
+    sj::encode(w, p);
+    w.endObject();
+    return append();
+}
+
+bool ConfigStore::appendAdd(const ProcessConfig& p) {
+    return appendProcess("add", p);
+}
+
+bool ConfigStore::appendUpdate(const ProcessConfig& p) {
+    return appendProcess("update", p);
+}
+
+bool ConfigStore::appendDelete(const std::string& id) {
+    m_buf.clear();
+    sj::Writer w(m_buf);
+    recordHead(w, "delete").key("id").value(id).endObject();
+    return append();
+}
+
+bool ConfigStore::appendSettings(const AppConfig& cfg) {
+    m_buf.clear();
+    sj::Writer w(m_buf);
+    recordHead(w, "settings")
+        .key("autoStartOnOpen").value(cfg.autoStartOnOpen)
+        .key("launchConcurrency").value(cfg.launchConcurrency)
+        .endObject();
+    return append();
+}
+
+bool ConfigStore::append() {
+    m_buf += '\n';
+    if (m_journal.is_open()) {
+        m_journal.write(m_buf.data(), (std::streamsize)m_buf.size());
+        m_journal.flush();
+    }
+    if (!m_journal.is_open() || !m_journal) {
+        // 写了一半的行在重放时会被跳过
+        m_journal.clear();
+        return false;
+    }
+    m_journalBytes += m_buf.size();
+    return true;
+}
+
+bool ConfigStore::seal(std::string& error) {
+    m_journal.close();
+    bool moved = fileops::replace(m_journalPath, m_sealedPath, error);
+    m_journal.clear();
+    m_journal.open(m_journalPath, std::ios::binary | std::ios::app);
+    if (moved) m_journalBytes = 0;
+    return moved;
+}
+
+bool ConfigStore::removeSealed() {
+    return fileops::remove(m_sealedPath);
+}
+
+void ConfigStore::truncateJournal() {
+    if (!m_journal.is_open()) return;
+    m_journal.close();
+    m_journal.clear();
+    m_journal.open(m_journalPath, std::ios::binary | std::ios::trunc);
+    m_journalBytes = 0;
+}
+
+void ConfigStore::discardJournals() {
+    fileops::remove(m_sealedPath);
+    truncateJournal();
+}
+
+size_t ConfigStore::replayJournal(const std::string& path, ConfigSnapshot& snap, size_t& bad) {
+    static constexpr sj::FieldMask kProcess   = sj::fieldMask<JournalRecord>("process");
+    static constexpr sj::FieldMask kId        = sj::fieldMask<JournalRecord>("id");
+    static constexpr sj::FieldMask kAutoStart = sj::fieldMask<JournalRecord>("autoStartOnOpen");
+    static constexpr sj::FieldMask kLaunchCap = sj::fieldMask<JournalRecord>("launchConcurrency");
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) return 0;
+
+    auto& cfg   = snap.config;
+    auto& procs = cfg.processes;
+    auto& index = snap.index;
+
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        JournalRecord rec;
+        sj::FieldMask present = 0;
+        try { present = sj::decode(line, rec); } catch (...) { ++bad; continue; }
+
+        // 记录携带修改后的完整状态，按 id 覆盖即可，重复重放结果不变
+        if (rec.op == "add" || rec.op == "update") {
+            if (!(present & kProcess) || rec.process.id.empty()) { ++bad; continue; }
+            auto it = index.find(rec.process.id);
+            if (it != index.end()) {
+                procs[it->second] = std::move(rec.process);
+            } else {
+                index.emplace(rec.process.id, procs.size());
+                procs.push_back(std::move(rec.process));
+            }
+        } else if (rec.op == "delete") {
+            if (!(present & kId)) { ++bad; continue; }
+            auto it = index.find(rec.id);
+            if (it != index.end()) {
+                size_t slot = it->second;
+                index.erase(it);
+                procs.erase(procs.begin() + slot);
+                snap.reindex(slot);
+            }
+        } else if (rec.op == "settings") {
+            if (present & kAutoStart) cfg.autoStartOnOpen   = rec.autoStartOnOpen;
+            if (present & kLaunchCap) cfg.launchConcurrency = rec.launchConcurrency;
+        } else {
+            ++bad;
+            continue;
+        }
+        ++applied;
+    }
+    return applied;
+}
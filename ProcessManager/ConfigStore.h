@@ -0,0 +1,97 @@
+// ConfigStore.h  -  config.json、增量日志 config.journal 与启动缓存 config.cache 的格式与落盘（与平台无关）
+// 只规定各文件的写入顺序，加锁、去抖与后台写入由 ConfigService 负责。进程在任意两步之间被杀掉，
+// load() 都能恢复最后一次提交的状态：
+//   快照：writeTemp() 写出并刷盘 config.json.tmp，replaceConfig() 原子替换 config.json
+//   日志：append*() 追加的一行刷出即为提交；seal() 把日志改名为 config.journal.old 并另起一份，
+//         覆盖封存内容的快照替换成功后由 removeSealed() 删除。记录按 id 覆盖，重复重放结果不变
+// 快照经 fsync 落盘；日志每行只刷到操作系统而不 fsync，已提交的修改能扛住本进程崩溃，
+// 但掉电或系统崩溃时可能丢失最后若干行（不会损坏已有内容，残缺的行在重放时跳过）
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include "ConfigTypes.h"
+
+class ConfigStore {
+public:
+    // 当前日志达到此大小后封存，并入下一次快照
+    static constexpr uint64_t kJournalCompactBytes = 256 * 1024;
+
+    // 临时文件为 configPath + ".tmp"，封存日志为 journalPath + ".old"
+    ConfigStore(std::string configPath, std::string journalPath);
+
+    const std::string& configPath() const { return m_configPath; }
+
+    // ─── 恢复 ───
+    // 解析 config.json 的文本，格式错误或值之后有多余内容时返回 false，cfg 恢复为默认配置
+    static bool parse(std::string_view text, AppConfig& cfg);
+
+    // 读取 config.json 到空的 snap，补上缺失的 id 并建索引，再经 recover() 重放日志。
+    // 文件不存在或为空时为默认配置；无法解析时返回 false
+    bool load(ConfigSnapshot& snap);
+
+    // 在由 config.json 得到、已建好索引的 snap 上依次重放封存日志与当前日志，返回应用的记录数，
+    // 无法解析而跳过的行数累加到 bad。parsed 为 false（config.json 损坏）时日志失去重放基准，
+    // 不重放而由 setAsideJournals() 移开
+    size_t recover(ConfigSnapshot& snap, bool parsed, size_t& bad);
+
+    // 把封存日志与当前日志改名为原名加 ".bad"，留给人工核对，返回移开的文件数。
+    // 改名失败的文件原样保留，不会删除
+    size_t setAsideJournals();
+
+    bool hasSealed() const;
+
+    // ─── 启动缓存 ───
+    // 定长文件头（魔数、字段表指纹、config.json 的内容哈希、正文哈希与长度）加 AppConfig 按位置的
+    // MessagePack 编码（sj::msgpack::encodeTuple）：字段表由指纹保证一致，正文不写成员名，解码时无需匹配键。
+    // 缓存只在生成它的机器上使用，文件头按本机字节序写出
+
+    // FNV-1a 的按 8 字节分组变体：每次吸收一个机器字，大文件的哈希开销远小于 JSON 解析
+    static uint64_t contentHash(std::string_view data);
+
+    static std::string encodeCache(uint64_t sourceHash, const AppConfig& cfg);
+
+    // 文件头与 sourceHash、当前字段表都一致且正文完整时解码到 cfg；否则返回 false，cfg 不变
+    static bool decodeCache(std::string_view bytes, uint64_t sourceHash, AppConfig& cfg);
+
+    // ─── 快照 ───
+    // 两步之间中断时 config.json 仍是完整的旧文件，残留的临时文件由下一次 writeTemp() 覆盖
+    bool writeTemp(const std::string& data, std::string& error);
+    bool replaceConfig(std::string& error);
+
+    // ─── 增量日志 ───
+    // 以下接口由调用方串行化；与快照接口操作不同的文件，两组接口可由不同的锁保护
+
+    // 以追加方式打开当前日志。上次在写一行时中断，先补上换行，之后的记录从新行开始
+    bool openJournal();
+    uint64_t journalBytes() const { return m_journalBytes; }
+
+    // 追加一条记录并刷出；日志不可用时返回 false，调用方应改为整体保存
+    bool appendAdd(const ProcessConfig& p);
+    bool appendUpdate(const ProcessConfig& p);
+    bool appendDelete(const std::string& id);
+    bool appendSettings(const AppConfig& cfg);
+
+    // 当前日志改名为封存日志并另起一份空日志
+    bool seal(std::string& error);
+    // 删除封存日志，本就不存在时也返回 true
+    bool removeSealed();
+    // 快照已包含当前日志的全部内容时清空它；日志未打开时不做任何事
+    void truncateJournal();
+    // 外部修改的 config.json 成为新基准：删除封存日志并清空当前日志
+    void discardJournals();
+
+private:
+    bool appendProcess(const char* op, const ProcessConfig& p);
+    bool append();   // 写出 m_buf 中的一条记录
+    static size_t replayJournal(const std::string& path, ConfigSnapshot& snap, size_t& bad);
+
+    std::string   m_configPath;
+    std::string   m_tempPath;
+    std::string   m_journalPath;
+    std::string   m_sealedPath;
+    std::ofstream m_journal;
+    std::string   m_buf;              // 单条记录的序列化缓冲区，跨调用复用
+    uint64_t      m_journalBytes = 0;
+};
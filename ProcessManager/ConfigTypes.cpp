@@ -0,0 +1,138 @@
+// ConfigTypes.cpp  -  配置数据结构
+#include "ConfigTypes.h"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+
+// ─── UUID 生成器 ─────────────────────────────────────────────────────────────
+std::string newProcessId() {
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    static std::uniform_int_distribution<uint32_t> dis;
+    std::ostringstream oss;
+    auto r = [&]() { return dis(gen); };
+    oss << std::hex << std::setfill('0');
+    oss << std::setw(8) << r() << '-';
+    oss << std::setw(4) << (r() & 0xFFFF) << '-';
+    oss << std::setw(4) << ((r() & 0x0FFF) | 0x4000) << '-';
+    oss << std::setw(4) << ((r() & 0x3FFF) | 0x8000) << '-';
+    oss << std::setw(4) << (r() & 0xFFFF);
+    oss << std::setw(8) << r();
+    return oss.str();
+}
+
+// ─── 根据扩展名判断类型 ──────────────────────────────────────────────────────
+std::string processTypeFromPath(const std::string& path) {
+    auto pos = path.rfind('.');
+    if (pos == std::string::npos) return "exe";
+    std::string ext = path.substr(pos + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    if (ext == "bat" || ext == "cmd") return "bat";
+    return "exe";
+}
+
+// ─── 解码默认值 ──────────────────────────────────────────────────────────────
+void sj_decoded(ProcessConfig& p, sj::FieldMask present) {
+    constexpr sj::FieldMask kId         = sj::fieldMask<ProcessConfig>("id");
+    constexpr sj::FieldMask kType       = sj::fieldMask<ProcessConfig>("type");
+    constexpr sj::FieldMask kGuardDelay = sj::fieldMask<ProcessConfig>("guardDelaySeconds");
+    if (!(present & kGuardDelay)) p.guardDelaySeconds = 3;
+    if (!(present & kId))         p.id.clear();
+    if (!(present & kType))       p.type = processTypeFromPath(p.path);
+}
+
+// ─── 补全 id ─────────────────────────────────────────────────────────────────
+size_t assignMissingIds(AppConfig& cfg, const ConfigSnapshot* prev) {
+    auto& procs = cfg.processes;
+    std::unordered_set<std::string> used;
+    size_t missing = 0;
+    for (const auto& p : procs) {
+        if (p.id.empty()) ++missing;
+        else used.insert(p.id);
+    }
+    if (missing == 0) return 0;
+
+    auto take = [&](ProcessConfig& p, const ProcessConfig& old) {
+        if (old.id.empty() || !used.insert(old.id).second) return false;
+        p.id = old.id;
+        return true;
+    };
+    if (prev) {
+        const auto& olds = prev->config.processes;
+        for (size_t i = 0; i < procs.size() && i < olds.size(); ++i) {
+            ProcessConfig& p = procs[i];
+            if (p.id.empty() && p.name == olds[i].name && p.path == olds[i].path) take(p, olds[i]);
+        }
+        // 名称 → prev 中的下标，重名的名称不参与匹配
+        constexpr size_t kAmbiguous = ~(size_t)0;
+        std::unordered_map<std::string, size_t> byName;
+        for (size_t i = 0; i < olds.size(); ++i) {
+            if (olds[i].name.empty()) continue;
+            auto [it, fresh] = byName.emplace(olds[i].name, i);
+            if (!fresh) it->second = kAmbiguous;
+        }
+        for (auto& p : procs) {
+            if (!p.id.empty()) continue;
+            auto it = byName.find(p.name);
+            if (it != byName.end() && it->second != kAmbiguous) take(p, olds[it->second]);
+        }
+    }
+    for (auto& p : procs)
+        if (p.id.empty()) p.id = newProcessId();
+    return missing;
+}
+
+// ─── 版本比较 ────────────────────────────────────────────────────────────────
+bool diffConfig(const ConfigSnapshot& cur, const ConfigSnapshot& next, ConfigDiff& diff) {
+    static constexpr sj::FieldMask kRelaunch =
+        sj::fieldMask<ProcessConfig>("path") | sj::fieldMask<ProcessConfig>("type") |
+        sj::fieldMask<ProcessConfig>("args") | sj::fieldMask<ProcessConfig>("background");
+
+    bool changed = next.config.autoStartOnOpen != cur.config.autoStartOnOpen ||
+                   next.config.launchConcurrency != cur.config.launchConcurrency ||
+                   next.config.processes.size() != cur.config.processes.size();
+    diff = ConfigDiff{};
+    for (size_t i = 0; i < next.config.processes.size(); ++i) {
+        const ProcessConfig& p = next.config.processes[i];
+        auto it = cur.index.find(p.id);
+        if (it == cur.index.end()) { diff.added.push_back(p.id); continue; }
+        sj::FieldMask m = sj::diffFields(cur.config.processes[it->second], p);
+        if (m & kRelaunch) diff.relaunch.push_back(p.id);
+        changed |= m != 0 || it->second != i;   // 仅顺序变化也需发布
+    }
+    for (const auto& p : cur.config.processes)
+        if (!next.find(p.id)) diff.removed.push_back(p.id);
+    return changed || !diff.added.empty() || !diff.removed.empty();
+}
+
+// ─── id 索引 ─────────────────────────────────────────────────────────────────
+const ProcessConfig* ConfigSnapshot::find(const std::string& id) const {
+    auto it = index.find(id);
+    return it != index.end() ? &config.processes[it->second] : nullptr;
+}
+
+void ConfigSnapshot::reindex(size_t from) {
+    const auto& procs = config.processes;
+    if (from == 0) {
+        index.clear();
+        index.reserve(procs.size());
+    }
+    for (size_t i = from; i < procs.size(); ++i) index[procs[i].id] = i;
+}
+
+// ─── 校验结果 ─────────────────────────────────────────────────────────────────
+const ConfigIssue* ConfigValidation::issueOf(const ProcessConfig& p) const {
+    auto it = issues.find(p.id);
+    if (it == issues.end()) return nullptr;
+    if (!it->second.configError && it->second.path != p.path) return nullptr;
+    return &it->second;
+}
+
+std::string checkRestartRule(const ProcessConfig& p) {
+    const std::string& r = p.restartOn;
+    if (r == "always" || r == "on-failure" || r == "codes" || r == "never") return {};
+    return "restartOn 取值无效：\"" + r + "\"（应为 always、on-failure、codes 或 never）";
+}
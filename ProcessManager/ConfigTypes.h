@@ -0,0 +1,109 @@
+// ConfigTypes.h  -  配置数据结构（与平台无关，供 ConfigService 与 Supervisor 共用）
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include "SimpleJson.hpp"
+
+// ─── 数据结构 ─────────────────────────────────────────────────────────────────
+
+struct ProcessConfig {
+    std::string id;
+    std::string name;
+    std::string path;
+    std::string type;          // "exe" 或 "bat"
+    std::string args;
+    int         delaySeconds      = 0;
+    bool        guardEnabled      = true;
+    int         guardDelaySeconds = 1;
+    bool        enabled           = true;
+    bool        background        = false; // 后台进程：启动时不创建控制台窗口
+    int         priority          = 0;     // 启动优先级：同时排队时数值大的先启动
+    std::vector<std::string> dependsOn;    // 依赖的进程 id：它们全部进入运行状态后才启动本进程
+    // 守护重启规则（guardEnabled 为 false 即从不重启）
+    std::string restartOn         = "always";   // "always" 任何退出、"on-failure" 退出码非 0、"codes" 仅 restartCodes、"never" 从不
+    std::vector<uint32_t> restartCodes;         // restartOn 为 "codes" 时触发重启的退出码
+    int         backoffMaxSeconds = 60;    // 连续崩溃时重启延迟逐次翻倍的上限；连续运行超过此时长视为恢复
+    int         maxRestarts       = 10;    // restartWindowSeconds 内最多守护重启次数，超出即停止守护；0 表示不限
+    int         restartWindowSeconds = 300;
+};
+
+// JSON 字段表：新增持久化字段只需在结构体和这里各加一处
+SJ_FIELDS(ProcessConfig, id, name, path, type, args, delaySeconds,
+          guardEnabled, guardDelaySeconds, enabled, background, priority, dependsOn,
+          restartOn, restartCodes, backoffMaxSeconds, maxRestarts, restartWindowSeconds)
+
+// 解码完一个进程对象后补全缺失字段：type 按扩展名推断、守护延迟默认 3 秒。
+// 缺少的 id 保持为空，由 assignMissingIds 统一补上
+void sj_decoded(ProcessConfig& p, sj::FieldMask present);
+
+// 生成类 UUID 的唯一 id
+std::string newProcessId();
+
+// 根据文件扩展名判断进程类型：.bat / .cmd 为 "bat"，其余为 "exe"
+std::string processTypeFromPath(const std::string& path);
+
+struct AppConfig {
+    bool                       autoStartOnOpen   = false;
+    int                        launchConcurrency = 0;   // 同时创建进程的上限，0 表示按 CPU 核数
+    std::vector<ProcessConfig> processes;
+};
+
+SJ_FIELDS(AppConfig, autoStartOnOpen, launchConcurrency, processes)
+
+// 一个已发布的配置版本：发布后不再修改，读线程持有 shared_ptr 即可安全访问，
+// 写入方复制一份修改后整体替换（写时复制）
+struct ConfigSnapshot {
+    // id → processes 中的下标
+    using IdIndex = std::unordered_map<std::string, size_t>;
+
+    AppConfig config;
+    IdIndex   index;
+
+    // O(1) 按 id 查找，不存在时返回 nullptr；指针在快照存活期间有效
+    const ProcessConfig* find(const std::string& id) const;
+
+    // 从 from 起重建下标（删除后其后元素整体前移）
+    void reindex(size_t from = 0);
+};
+
+using ConfigPtr = std::shared_ptr<const ConfigSnapshot>;
+
+// 外部改写 config.json 后按 id 比较新旧版本的结果，供 ProcessService 增量应用。
+// 只列出需要启停的条目；其余字段的修改随新版本发布生效，无需处理（见 Supervisor::applyConfigDiff）
+struct ConfigDiff {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<std::string> relaunch;   // path / type / args / background 有变化，运行中的需重启
+};
+
+// 为 cfg 中没有 id 的条目补上 id，返回补上的条目数，调用方据此把 id 写回文件。
+// 热重载时先沿用 prev 中对应条目的 id，否则每次读取文件都会生成新 id，被当作删除后新增而重启：
+// 同一位置且 name、path 均相同的条目优先，其次是 prev 中唯一同名的条目；
+// 已被其他条目占用的 id 不会重复使用，仍无对应的条目生成新 id
+size_t assignMissingIds(AppConfig& cfg, const ConfigSnapshot* prev = nullptr);
+
+// 按 id 比较两个已建好索引的版本并填写 diff；内容与顺序都相同时返回 false
+bool diffConfig(const ConfigSnapshot& cur, const ConfigSnapshot& next, ConfigDiff& diff);
+
+// 单个条目未通过校验的原因
+struct ConfigIssue {
+    std::string  path;               // 校验时的路径；条目路径之后被修改则该结果作废
+    std::string  message;            // UTF-8
+    bool         configError = false;  // 配置本身的问题（id 重复、取值无效），与路径无关
+};
+
+// 与路径无关的单条目检查：restartOn 须为已知取值。未通过时返回原因（UTF-8），两种宿主的校验共用
+std::string checkRestartRule(const ProcessConfig& p);
+
+// 一次配置校验的结果，发布方式与 ConfigSnapshot 相同
+struct ConfigValidation {
+    std::unordered_map<std::string, ConfigIssue> issues;   // 按 id，只含未通过的条目
+
+    // 条目 p 已知的问题；未发现问题或结果已过期时返回 nullptr
+    const ConfigIssue* issueOf(const ProcessConfig& p) const;
+};
+
+using ValidationPtr = std::shared_ptr<const ConfigValidation>;
@@ -0,0 +1,19 @@
+// FileOps.h  -  配置落盘用到的少量文件操作
+// Win32FileOps.cpp 与 PosixFileOps.cpp 分别实现，各自只编入对应平台的构建
+#pragma once
+#include <string>
+
+namespace fileops {
+
+// 创建或截断 path，写入 data 并刷到磁盘后关闭；失败时 error 为原因
+bool writeDurable(const std::string& path, const std::string& data, std::string& error);
+
+// 将 from 改名为 to，to 已存在时原子替换；返回前改名本身也已落盘
+bool replace(const std::string& from, const std::string& to, std::string& error);
+
+// 删除 path，文件本就不存在时也返回 true
+bool remove(const std::string& path);
+
+bool exists(const std::string& path);
+
+} // namespace fileops
@@ -0,0 +1,81 @@
+// LaunchPool.cpp  -  有界并发的启动线程池
+#include "LaunchPool.h"
+#include <algorithm>
+
+LaunchPool::LaunchPool(unsigned limit) : m_limit(resolve(limit)) {}
+
+LaunchPool::~LaunchPool() { stop(); }
+
+unsigned LaunchPool::resolve(unsigned limit) {
+    if (limit) return limit;
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores ? cores : 4;
+}
+
+bool LaunchPool::runsLater(const Item& a, const Item& b) {
+    if (a.priority != b.priority) return a.priority < b.priority;
+    return a.seq > b.seq;
+}
+
+// 线程数跟着“执行中 + 排队”的需求增长，直到上限；空闲线程留着复用
+void LaunchPool::growLocked() {
+    size_t demand = std::min<size_t>(m_limit, m_active + m_queue.size());
+    while (m_workers.size() < demand) m_workers.emplace_back(&LaunchPool::work, this);
+}
+
+void LaunchPool::submit(int priority, Task task) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_stop) return;
+        m_queue.push_back(Item{ priority, m_seq++, std::move(task) });
+        std::push_heap(m_queue.begin(), m_queue.end(), runsLater);
+        growLocked();
+    }
+    m_cv.notify_one();
+}
+
+void LaunchPool::setLimit(unsigned limit) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        unsigned next = resolve(limit);
+        if (next == m_limit || m_stop) return;
+        m_limit = next;
+        growLocked();
+    }
+    m_cv.notify_all();
+}
+
+void LaunchPool::stop() {
+    std::vector<std::thread> workers;
+    std::vector<Item> dropped;   // 任务捕获的对象在锁外析构
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+        dropped.swap(m_queue);
+        workers.swap(m_workers);
+    }
+    m_cv.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void LaunchPool::work() {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    for (;;) {
+        // 上限调低后多出的线程在这里等待，直到执行中的任务降到上限以下
+        m_cv.wait(lk, [&] { return m_stop || (!m_queue.empty() && m_active < m_limit); });
+        if (m_stop) return;
+
+        std::pop_heap(m_queue.begin(), m_queue.end(), runsLater);
+        Task task = std::move(m_queue.back().task);
+        m_queue.pop_back();
+        ++m_active;
+
+        lk.unlock();
+        task();
+        task = nullptr;
+        lk.lock();
+
+        --m_active;
+        if (!m_queue.empty()) m_cv.notify_one();
+    }
+}
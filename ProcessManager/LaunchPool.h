@@ -0,0 +1,50 @@
+// LaunchPool.h  -  有界并发的启动线程池
+// 创建进程（命令行转换、CreateProcess、Job 设置、日志）在这里并行执行，不占用 UI 线程；
+// 同时执行的任务数有上限，排队任务按优先级出队，同优先级按提交顺序
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class LaunchPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit LaunchPool(unsigned limit = 0);   // 0 表示按 CPU 核数
+    ~LaunchPool();                             // 同 stop()
+
+    LaunchPool(const LaunchPool&) = delete;
+    LaunchPool& operator=(const LaunchPool&) = delete;
+
+    // priority 大的先执行；工作线程按需创建，数量不超过上限
+    void submit(int priority, Task task);
+
+    // 调整并发上限（0 表示按 CPU 核数）；已在执行的任务不受影响
+    void setLimit(unsigned limit);
+
+    // 丢弃尚未开始的任务并等待执行中的任务结束，之后的 submit 被忽略。不能在任务中调用
+    void stop();
+
+private:
+    struct Item {
+        int      priority;
+        uint64_t seq;
+        Task     task;
+    };
+    static bool runsLater(const Item& a, const Item& b);   // 堆比较：a 比 b 晚出队
+    static unsigned resolve(unsigned limit);
+    void growLocked();
+    void work();
+
+    std::mutex               m_mutex;    // 保护以下状态
+    std::condition_variable  m_cv;
+    std::vector<Item>        m_queue;    // 以 runsLater 维护的堆
+    std::vector<std::thread> m_workers;
+    unsigned                 m_limit;
+    unsigned                 m_active = 0;
+    uint64_t                 m_seq    = 0;
+    bool                     m_stop   = false;
+};
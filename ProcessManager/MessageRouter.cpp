@@ -36,29 +36,32 @@ static std::wstring utf8ToWide(const std::string& s) {
 // ─── 消息分发 ────────────────────────────────────────────────────────────────
 void MessageRouter::dispatch(const std::wstring& json) {
     std::string utf8 = wideToUtf8(json);
-    sj::Value msg;
-    try { msg = sj::parse(utf8); } catch (...) { return; }
-    if (!msg.is_object() || !msg.contains("action")) return;
+    // 只校验结构、不构建 DOM：action 等字段按需解码，子对象以原始文本交给处理函数，
+    // 消息中的每个字节至多被解码一次
+    sj::Lazy msg;
+    try { msg = sj::Lazy::parse(utf8); } catch (...) { return; }
+    if (!msg.is_object()) return;
 
     std::string action = msg["action"].get_string_or("");
+    if (action.empty()) return;
 
     if (action == "getProcessList") {
         handleGetProcessList();
     } else if (action == "startProcess") {
-        handleStartProcess(msg.contains("id") ? msg["id"].get_string_or("") : "");
+        handleStartProcess(msg["id"].get_string_or(""));
     } else if (action == "stopProcess") {
-        handleStopProcess(msg.contains("id") ? msg["id"].get_string_or("") : "");
+        handleStopProcess(msg["id"].get_string_or(""));
     } else if (action == "addProcess") {
-        handleAddProcess(msg.contains("process") ? sj::stringify(msg["process"]) : "{}");
+        handleAddProcess(msg["process"].raw_or("{}"));
     } else if (action == "updateProcess") {
-        handleUpdateProcess(msg.contains("process") ? sj::stringify(msg["process"]) : "{}");
+        handleUpdateProcess(msg["process"].raw_or("{}"));
     } else if (action == "deleteProcess") {
-        handleDeleteProcess(msg.contains("id") ? msg["id"].get_string_or("") : "");
+        handleDeleteProcess(msg["id"].get_string_or(""));
     } else if (action == "openFilePicker") {
         HWND hwnd = ProcessService::instance().mainHwnd();
         handleOpenFilePicker(hwnd);
     } else if (action == "saveConfig") {
-        handleSaveConfig(msg.contains("config") ? sj::stringify(msg["config"]) : "{}");
+        handleSaveConfig(msg["config"].raw_or("{}"));
     } else if (action == "getConfig") {
         handleGetConfig();
     } else if (action == "startAll") {
@@ -74,28 +77,27 @@ void MessageRouter::handleGetProcessList() {
 }
 
 void MessageRouter::pushProcessList() {
-    auto& cfg = ConfigService::instance().config();
-    sj::Array arr;
+    ConfigPtr     snap  = ConfigService::instance().snapshot();
+    ValidationPtr check = ConfigService::instance().validation();
+    const AppConfig& cfg = snap->config;
+    m_sendBuf.clear();
+    sj::Writer w(m_sendBuf);
+    w.startObject()
+     .key("type").value("processListResponse")
+     .key("processes").startArray();
     for (const auto& p : cfg.processes) {
-        sj::Object obj;
-        obj["id"]               = p.id;
-        obj["name"]             = p.name;
-        obj["path"]             = p.path;
-        obj["type"]             = p.type;
-        obj["args"]             = p.args;
-        obj["delaySeconds"]     = p.delaySeconds;
-        obj["guardEnabled"]     = p.guardEnabled;
-        obj["guardDelaySeconds"]= p.guardDelaySeconds;
-        obj["enabled"]          = p.enabled;
-        obj["background"]       = p.background;
-        obj["status"]           = std::string(statusStr(ProcessService::instance().getStatus(p.id)));
-        obj["pid"]              = (int)ProcessService::instance().getPid(p.id);
-        arr.push_back(sj::Value(std::move(obj)));
+        w.startObject();
+        sj::encodeFields(w, p);
+        const ConfigIssue* issue = check->issueOf(p);
+        w.key("status").value(statusStr(ProcessService::instance().getStatus(p.id)))
+         .key("pid").value(ProcessService::instance().getPid(p.id))
+         .key("issue").value(issue ? issue->message : std::string())
+         .key("backoff");
+        sj::encode(w, ProcessService::instance().getRestartState(p.id));
+        w.endObject();
     }
-    sj::Object resp;
-    resp["type"]    = std::string("processListResponse");
-    resp["processes"] = std::move(arr);
-    WebViewHost::instance().sendMessage(sj::stringify(sj::Value(resp)));
+    w.endArray().endObject();
+    WebViewHost::instance().sendMessage(m_sendBuf);
 }
 
 // ─── 启动 / 停止进程 ──────────────────────────────────────────────────────────
@@ -112,61 +114,49 @@ void MessageRouter::handleStopProcess(const std::string& id) {
 
 // ─── 推送进程状态变更 ────────────────────────────────────────────────────────
 void MessageRouter::pushProcessStatus(const std::string& id, const std::string& status) {
-    sj::Object resp;
-    resp["type"]   = std::string("processStatusChanged");
-    resp["id"]     = id;
-    resp["status"] = status;    resp["pid"]    = (int)ProcessService::instance().getPid(id);    WebViewHost::instance().sendMessage(sj::stringify(sj::Value(resp)));
+    m_sendBuf.clear();
+    sj::Writer w(m_sendBuf);
+    w.startObject()
+     .key("type").value("processStatusChanged")
+     .key("id").value(id)
+     .key("status").value(status)
+     .key("pid").value(ProcessService::instance().getPid(id))
+     .key("backoff");
+    sj::encode(w, ProcessService::instance().getRestartState(id));
+    w.endObject();
+    WebViewHost::instance().sendMessage(m_sendBuf);
 }
 
 // ─── 添加进程 ────────────────────────────────────────────────────────────────
-void MessageRouter::handleAddProcess(const std::string& jsonObj) {
-    sj::Value pv;
-    try { pv = sj::parse(jsonObj); } catch (...) { return; }
-    if (!pv.is_object()) return;
-
+void MessageRouter::handleAddProcess(std::string_view jsonObj) {
     ProcessConfig p;
-    p.id               = ConfigService::newId();
-    p.name             = pv.contains("name")             ? pv["name"].get_string_or("") : "";
-    p.path             = pv.contains("path")             ? pv["path"].get_string_or("") : "";
-    p.type             = pv.contains("type")             ? pv["type"].get_string_or("exe") : ConfigService::typeFromPath(p.path);
-    p.args             = pv.contains("args")             ? pv["args"].get_string_or("") : "";
-    p.delaySeconds     = pv.contains("delaySeconds")     ? pv["delaySeconds"].get_int_or(0) : 0;
-    p.guardEnabled     = pv.contains("guardEnabled")     ? pv["guardEnabled"].get_bool_or(true) : true;
-    p.guardDelaySeconds= pv.contains("guardDelaySeconds")? pv["guardDelaySeconds"].get_int_or(3) : 3;
-    p.enabled          = pv.contains("enabled")          ? pv["enabled"].get_bool_or(true) : true;
-    p.background       = pv.contains("background")       ? pv["background"].get_bool_or(false) : false;
-
-    ConfigService::instance().config().processes.push_back(p);
-    ConfigService::instance().save();
+    try {
+        if (!sj::decode(jsonObj, p)) return;   // 不是对象
+    } catch (...) { return; }
+    p.id = ConfigService::newId();             // 新进程总是分配新 id，忽略前端传入的值
+
+    ConfigService::instance().addProcess(p);
     ProcessService::instance().syncConfig();
     pushProcessList();
 }
 
 // ─── 更新进程 ────────────────────────────────────────────────────────────────
-void MessageRouter::handleUpdateProcess(const std::string& jsonObj) {
-    sj::Value pv;
-    try { pv = sj::parse(jsonObj); } catch (...) { return; }
-    if (!pv.is_object()) return;
-
-    std::string id = pv.contains("id") ? pv["id"].get_string_or("") : "";
-    if (id.empty()) return;
-
-    auto& procs = ConfigService::instance().config().processes;
-    auto it = std::find_if(procs.begin(), procs.end(),
-        [&](const ProcessConfig& c) { return c.id == id; });
-    if (it == procs.end()) return;
-
-    if (pv.contains("name"))             it->name             = pv["name"].get_string_or(it->name);
-    if (pv.contains("path"))             it->path             = pv["path"].get_string_or(it->path);
-    if (pv.contains("type"))             it->type             = pv["type"].get_string_or(it->type);
-    if (pv.contains("args"))             it->args             = pv["args"].get_string_or(it->args);
-    if (pv.contains("delaySeconds"))     it->delaySeconds     = pv["delaySeconds"].get_int_or(it->delaySeconds);
-    if (pv.contains("guardEnabled"))     it->guardEnabled     = pv["guardEnabled"].get_bool_or(it->guardEnabled);
-    if (pv.contains("guardDelaySeconds"))it->guardDelaySeconds= pv["guardDelaySeconds"].get_int_or(it->guardDelaySeconds);
-    if (pv.contains("enabled"))          it->enabled          = pv["enabled"].get_bool_or(it->enabled);
-    if (pv.contains("background"))       it->background       = pv["background"].get_bool_or(it->background);
-
-    ConfigService::instance().save();
+void MessageRouter::handleUpdateProcess(std::string_view jsonObj) {
+    static constexpr sj::FieldMask kId = sj::fieldMask<ProcessConfig>("id");
+
+    // 只有 JSON 中出现且类型正确的字段会被写回
+    ProcessConfig upd;
+    sj::FieldMask present = 0;
+    try { present = sj::decode(jsonObj, upd); } catch (...) { return; }
+    if (!(present & kId) || upd.id.empty()) return;
+
+    ConfigPtr snap = ConfigService::instance().snapshot();
+    const ProcessConfig* cur = snap->find(upd.id);
+    if (!cur) return;
+
+    ProcessConfig next = *cur;
+    sj::assignFields(next, upd, present & ~kId);
+    ConfigService::instance().updateProcess(next);
     pushProcessList();
 }
 
@@ -176,10 +166,7 @@ void MessageRouter::handleDeleteProcess(const std::string& id) {
     // 先停止进程
     ProcessService::instance().stopProcess(id);
 
-    auto& procs = ConfigService::instance().config().processes;
-    procs.erase(std::remove_if(procs.begin(), procs.end(),
-        [&](const ProcessConfig& c) { return c.id == id; }), procs.end());
-    ConfigService::instance().save();
+    ConfigService::instance().removeProcess(id);
     pushProcessList();
 }
 
@@ -208,24 +195,27 @@ void MessageRouter::handleOpenFilePicker(HWND hwnd) {
     std::string path = wideToUtf8(wpath.get());
     std::string type = ConfigService::typeFromPath(path);
 
-    sj::Object resp;
-    resp["type"] = std::string("filePickerResult");
-    resp["path"] = path;
-    resp["fileType"] = type;
-    WebViewHost::instance().sendMessage(sj::stringify(sj::Value(resp)));
+    m_sendBuf.clear();
+    sj::Writer(m_sendBuf).startObject()
+        .key("type").value("filePickerResult")
+        .key("path").value(path)
+        .key("fileType").value(type)
+        .endObject();
+    WebViewHost::instance().sendMessage(m_sendBuf);
 }
 
 // ─── 保存配置 ────────────────────────────────────────────────────────────────
-void MessageRouter::handleSaveConfig(const std::string& jsonObj) {
-    sj::Value cv;
-    try { cv = sj::parse(jsonObj); } catch (...) { return; }
-    if (!cv.is_object()) return;
+void MessageRouter::handleSaveConfig(std::string_view jsonObj) {
+    static constexpr sj::FieldMask kAutoStart = sj::fieldMask<AppConfig>("autoStartOnOpen");
+    static constexpr sj::FieldMask kLaunchCap = sj::fieldMask<AppConfig>("launchConcurrency");
 
-    if (cv.contains("autoStartOnOpen"))
-        ConfigService::instance().config().autoStartOnOpen =
-            cv["autoStartOnOpen"].get_bool_or(false);
+    // 进程列表有独立的增删改消息，这里只接受全局设置
+    AppConfig upd;
+    sj::FieldMask present = 0;
+    try { present = sj::decode(jsonObj, upd); } catch (...) { return; }
+    if (present & kAutoStart) ConfigService::instance().setAutoStartOnOpen(upd.autoStartOnOpen);
+    if (present & kLaunchCap) ConfigService::instance().setLaunchConcurrency(upd.launchConcurrency);
 
-    ConfigService::instance().save();
     pushConfig();
 }
 
@@ -233,11 +223,15 @@ void MessageRouter::handleSaveConfig(const std::string& jsonObj) {
 void MessageRouter::handleGetConfig() { pushConfig(); }
 
 void MessageRouter::pushConfig() {
-    const auto& cfg = ConfigService::instance().config();
-    sj::Object resp;
-    resp["type"]            = std::string("configResponse");
-    resp["autoStartOnOpen"] = cfg.autoStartOnOpen;
-    WebViewHost::instance().sendMessage(sj::stringify(sj::Value(resp)));
+    ConfigPtr snap = ConfigService::instance().snapshot();
+    const AppConfig& cfg = snap->config;
+    m_sendBuf.clear();
+    sj::Writer(m_sendBuf).startObject()
+        .key("type").value("configResponse")
+        .key("autoStartOnOpen").value(cfg.autoStartOnOpen)
+        .key("launchConcurrency").value(cfg.launchConcurrency)
+        .endObject();
+    WebViewHost::instance().sendMessage(m_sendBuf);
 }
 
 // ─── 全部启动 / 全部停止 ─────────────────────────────────────────────────────
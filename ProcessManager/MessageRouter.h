@@ -1,6 +1,7 @@
 // MessageRouter.h  -  前端↔后端消息路由
 #pragma once
 #include <string>
+#include <string_view>
 #include <windows.h>
 
 class MessageRouter {
@@ -27,15 +28,19 @@ private:
     void handleGetProcessList();
     void handleStartProcess(const std::string& id);
     void handleStopProcess(const std::string& id);
-    void handleAddProcess(const std::string& jsonObj);
-    void handleUpdateProcess(const std::string& jsonObj);
+    // jsonObj 为消息中对应子对象的原始 JSON 文本，由处理函数自行解码
+    void handleAddProcess(std::string_view jsonObj);
+    void handleUpdateProcess(std::string_view jsonObj);
     void handleDeleteProcess(const std::string& id);
     void handleOpenFilePicker(HWND hwnd);
-    void handleSaveConfig(const std::string& jsonObj);
+    void handleSaveConfig(std::string_view jsonObj);
     void handleGetConfig();
     void handleStartAll();
     void handleStopAll();
 
     // 将 WebView2 传来的宽字符 JSON 转换为 UTF-8
     static std::string wideToUtf8(const std::wstring& w);
+
+    // 推送消息的紧凑 JSON 序列化缓冲区，跨调用复用（仅在 UI 线程访问）
+    std::string m_sendBuf;
 };
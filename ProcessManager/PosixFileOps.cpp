@@ -0,0 +1,63 @@
+// PosixFileOps.cpp  -  FileOps 的 Linux 实现
+#include "FileOps.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace fileops {
+
+static std::string withErrno(const char* what) {
+    return std::string(what) + "（" + std::strerror(errno) + "）";
+}
+
+bool writeDurable(const std::string& path, const std::string& data, std::string& error) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = withErrno("无法创建临时文件");
+        return false;
+    }
+    for (size_t off = 0; off < data.size();) {
+        ssize_t n = write(fd, data.data() + off, data.size() - off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            error = withErrno("写入失败");
+            close(fd);
+            return false;
+        }
+        off += (size_t)n;
+    }
+    if (fsync(fd) != 0) {
+        error = withErrno("刷盘失败");
+        close(fd);
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+bool replace(const std::string& from, const std::string& to, std::string& error) {
+    if (rename(from.c_str(), to.c_str()) != 0) {
+        error = withErrno("替换失败");
+        return false;
+    }
+    // 改名记录在目录中，同步目录后才算落盘
+    auto slash = to.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+}
+
+bool remove(const std::string& path) {
+    return unlink(path.c_str()) == 0 || errno == ENOENT;
+}
+
+bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+} // namespace fileops
@@ -0,0 +1,274 @@
+// PosixProcessBackend.cpp  -  Linux 进程后端
+#include "PosixProcessBackend.h"
+#include <spawn.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+extern char** environ;
+
+// 在退出回调中析构进程对象时不能等待回调自身结束
+static thread_local bool t_inExitCallback = false;
+
+namespace {
+
+// 单引号包裹，供 /bin/sh 原样解析
+std::string shellQuote(const std::string& s) {
+    std::string q = "'";
+    for (char c : s) {
+        if (c == '\'') q += "'\\''";
+        else q += c;
+    }
+    return q + "'";
+}
+
+// 无法取得退出状态（waitpid 失败）时报告的退出码，不能当作正常退出
+constexpr uint32_t kUnknownExitCode = 255;
+
+// 被信号终止时沿用 shell 的约定：128 + 信号编号
+uint32_t exitCodeOf(int status) {
+    if (WIFEXITED(status))   return (uint32_t)WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128u + (uint32_t)WTERMSIG(status);
+    return (uint32_t)status;
+}
+
+} // namespace
+
+// ─── 进程对象 ────────────────────────────────────────────────────────────────
+class PosixProcessBackend::Process : public IProcess {
+public:
+    Process(PosixProcessBackend& backend, pid_t pid, uint64_t key)
+        : m_backend(backend), m_pid(pid), m_key(key) {}
+
+    ~Process() override { m_backend.release(m_key); }
+
+    uint32_t pid() const override { return (uint32_t)m_pid; }
+
+    // 进程组号即根进程 PID；组内还有进程时该号码不会被系统复用
+    void killTree() override { kill(-m_pid, SIGKILL); }
+
+    void waitForExit(ExitCallback onExit) override { m_backend.arm(m_key, std::move(onExit)); }
+
+private:
+    PosixProcessBackend& m_backend;
+    pid_t                m_pid;
+    uint64_t             m_key;
+};
+
+// ─── 构造 / 析构 ─────────────────────────────────────────────────────────────
+PosixProcessBackend::PosixProcessBackend() {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event ev = {};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = 0;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &ev);
+    m_reaper = std::thread(&PosixProcessBackend::reapLoop, this);
+}
+
+PosixProcessBackend::~PosixProcessBackend() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    uint64_t one = 1;
+    (void)!write(m_wake, &one, sizeof(one));
+    m_reaper.join();
+    // 尚未退出的子进程不受影响，本进程退出后由 init 回收
+    for (auto& [key, w] : m_watches)
+        if (w.pidfd >= 0) close(w.pidfd);
+    close(m_wake);
+    close(m_epoll);
+}
+
+// ─── 启动进程 ────────────────────────────────────────────────────────────────
+// 参数串沿用 Windows 命令行的写法，交给 shell 拆分；exec 使返回的 PID 就是目标程序本身。
+// 程序不存在等 exec 阶段的错误表现为退出码 127，而不是启动失败
+std::unique_ptr<IProcess> PosixProcessBackend::spawn(const SpawnSpec& spec, std::string& error) {
+    std::string cmd;
+    if (!spec.workDir.empty()) cmd = "cd " + shellQuote(spec.workDir) + " && ";
+    cmd += spec.script ? "exec /bin/sh " : "exec ";
+    cmd += shellQuote(spec.path);
+    if (!spec.args.empty()) cmd += " " + spec.args;
+    char* argv[] = { const_cast<char*>("/bin/sh"), const_cast<char*>("-c"), cmd.data(), nullptr };
+
+    // 子进程自成进程组，并恢复默认的信号屏蔽字
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t none;
+    sigemptyset(&none);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+
+    // 后台进程：与终端断开，标准输入输出重定向到 /dev/null
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    if (spec.background) {
+        posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&fa, 2, "/dev/null", O_WRONLY, 0);
+    }
+
+    pid_t pid = 0;
+    int rc = posix_spawn(&pid, "/bin/sh", &fa, &attr, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    posix_spawnattr_destroy(&attr);
+    if (rc != 0) {
+        error = std::string("posix_spawn 失败：") + std::strerror(rc);
+        return nullptr;
+    }
+
+    // pidfd 始终指向这个进程，PID 被回收复用后也不会误等其他进程。
+    // ESRCH：SIGCHLD 被忽略时进程可能已退出并被内核回收，PID 随时会被复用，不能再发信号，
+    // 按已退出处理，等回调注册后报告 kUnknownExitCode
+    int pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd < 0 && errno == ESRCH)
+        return std::make_unique<Process>(*this, pid, watch(pid, -1));
+    if (pidfd < 0) {
+        int err = errno;
+        kill(-pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        error = std::string("pidfd_open 失败：") + std::strerror(err);
+        return nullptr;
+    }
+    return std::make_unique<Process>(*this, pid, watch(pid, pidfd));
+}
+
+// ─── 枚举子进程 ──────────────────────────────────────────────────────────────
+std::vector<uint32_t> PosixProcessBackend::listChildren(uint32_t pid) {
+    std::vector<uint32_t> children;
+    std::string p = std::to_string(pid);
+    std::ifstream in("/proc/" + p + "/task/" + p + "/children");
+    for (uint32_t child; in >> child;) children.push_back(child);
+    return children;
+}
+
+// ─── 等待退出 ────────────────────────────────────────────────────────────────
+// 登记后先不加入 epoll：在 arm 之前退出的进程保持僵尸状态，等回调注册后再回收，退出不会丢失。
+// 没有 pidfd 的条目（进程已被回收）在 arm 时交给回收线程直接回调
+uint64_t PosixProcessBackend::watch(pid_t pid, int pidfd) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t key = m_nextKey++;
+    m_watches.emplace(key, Watch{ pid, pidfd, {}, false });
+    return key;
+}
+
+void PosixProcessBackend::arm(uint64_t key, IProcess::ExitCallback onExit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_watches.find(key);
+    if (it == m_watches.end()) return;
+    it->second.onExit = std::move(onExit);
+    it->second.armed  = true;
+    if (it->second.pidfd < 0) {
+        m_reaped.push_back(key);
+        uint64_t one = 1;
+        (void)!write(m_wake, &one, sizeof(one));
+        return;
+    }
+    epoll_event ev = {};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = key;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, it->second.pidfd, &ev);
+}
+
+// 进程对象析构：不再回调，但进程仍交给回收线程，避免留下僵尸进程
+void PosixProcessBackend::release(uint64_t key) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_watches.find(key);
+    if (it != m_watches.end()) {
+        it->second.onExit = nullptr;
+        if (it->second.pidfd < 0) {
+            // 已回收，无需等待；已 arm 的条目由回收线程在取出时发现并跳过
+            m_watches.erase(it);
+            return;
+        }
+        if (!it->second.armed) {
+            it->second.armed = true;
+            epoll_event ev = {};
+            ev.events   = EPOLLIN;
+            ev.data.u64 = key;
+            epoll_ctl(m_epoll, EPOLL_CTL_ADD, it->second.pidfd, &ev);
+        }
+        return;
+    }
+    if (!t_inExitCallback)
+        m_idle.wait(lock, [&] { return m_running != key; });
+}
+
+void PosixProcessBackend::reapLoop() {
+    epoll_event evs[64];
+    for (;;) {
+        int n = epoll_wait(m_epoll, evs, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            uint64_t key = evs[i].data.u64;
+            if (key == 0) {
+                std::vector<uint64_t> reaped;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stop) return;
+                    uint64_t n;
+                    (void)!read(m_wake, &n, sizeof(n));
+                    reaped.swap(m_reaped);
+                }
+                for (uint64_t k : reaped) complete(k, kUnknownExitCode);
+                continue;
+            }
+            uint32_t code = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_watches.find(key);
+                if (it == m_watches.end()) continue;
+                int status = 0;
+                pid_t r;
+                do {
+                    r = waitpid(it->second.pid, &status, WNOHANG);
+                } while (r < 0 && errno == EINTR);
+                if (r == 0) continue;
+                code = r == it->second.pid ? exitCodeOf(status) : kUnknownExitCode;
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, it->second.pidfd, nullptr);
+            }
+            complete(key, code);
+        }
+    }
+}
+
+// 注销条目并在回收线程上执行退出回调；条目已被 release 移除时什么也不做
+void PosixProcessBackend::complete(uint64_t key, uint32_t code) {
+    IProcess::ExitCallback cb;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_watches.find(key);
+        if (it == m_watches.end()) return;
+        if (it->second.pidfd >= 0) close(it->second.pidfd);
+        cb = std::move(it->second.onExit);
+        m_watches.erase(it);
+        m_running = key;
+    }
+    if (cb) {
+        t_inExitCallback = true;
+        cb(code);
+        t_inExitCallback = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = 0;
+    }
+    m_idle.notify_all();
+}
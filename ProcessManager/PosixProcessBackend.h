@@ -0,0 +1,51 @@
+// PosixProcessBackend.h  -  Linux 进程后端
+// 不参与 Windows 构建；与 Supervisor.cpp、ConfigTypes.cpp 一起即可在 Linux 上编译运行守护核心
+#pragma once
+#include "ProcessBackend.h"
+#include <sys/types.h>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+// posix_spawn 经 /bin/sh 启动，子进程自成一个进程组，killTree 向整个组发送 SIGKILL；
+// 每个进程打开一个 pidfd，由单个回收线程在 epoll 上等待全部进程退出并 waitpid 回收
+class PosixProcessBackend : public IProcessBackend {
+public:
+    PosixProcessBackend();
+    ~PosixProcessBackend() override;
+
+    PosixProcessBackend(const PosixProcessBackend&) = delete;
+    PosixProcessBackend& operator=(const PosixProcessBackend&) = delete;
+
+    std::unique_ptr<IProcess> spawn(const SpawnSpec& spec, std::string& error) override;
+    std::vector<uint32_t> listChildren(uint32_t pid) override;
+
+private:
+    class Process;
+
+    struct Watch {
+        pid_t                  pid;
+        int                    pidfd;    // -1：进程在 pidfd_open 之前已被内核回收
+        IProcess::ExitCallback onExit;   // 进程对象析构后清空，进程仍照常回收
+        bool                   armed = false;   // 已加入 epoll
+    };
+
+    uint64_t watch(pid_t pid, int pidfd);
+    void     arm(uint64_t key, IProcess::ExitCallback onExit);
+    void     release(uint64_t key);
+    void     reapLoop();
+    void     complete(uint64_t key, uint32_t code);
+
+    int                     m_epoll = -1;
+    int                     m_wake  = -1;   // eventfd，通知回收线程退出
+    std::mutex              m_mutex;        // 保护以下状态
+    std::condition_variable m_idle;
+    std::unordered_map<uint64_t, Watch> m_watches;   // 以递增序号为键，避免 fd 复用混淆
+    std::vector<uint64_t>   m_reaped;       // 已 arm、没有 pidfd 的条目，经 m_wake 交给回收线程
+    uint64_t                m_nextKey = 1;            // 0 留给 m_wake
+    uint64_t                m_running = 0;            // 正在执行回调的条目
+    bool                    m_stop    = false;
+    std::thread             m_reaper;
+};
@@ -0,0 +1,48 @@
+// ProcessBackend.h  -  进程操作的平台抽象
+// Supervisor 只通过这里的接口启动、终止和等待进程，不直接调用任何系统 API：
+//   Win32ProcessBackend  —— CreateProcessW + Job Object + RegisterWaitForSingleObject
+//   PosixProcessBackend  —— posix_spawn + 进程组 + pidfd / epoll
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+// 一次启动所需的参数，字符串均为 UTF-8
+struct SpawnSpec {
+    std::string path;
+    std::string args;               // 原样附加在命令行之后
+    std::string workDir;            // 为空时继承当前目录
+    bool        script     = false; // 批处理 / shell 脚本，经系统命令解释器执行
+    bool        background = false; // 不创建控制台窗口
+};
+
+// 一个已启动的进程。析构时注销退出回调并释放句柄，但不终止进程；
+// 回调正在其他线程执行时等待其返回，在回调内部析构也是安全的
+class IProcess {
+public:
+    using ExitCallback = std::function<void(uint32_t exitCode)>;
+
+    virtual ~IProcess() = default;
+
+    virtual uint32_t pid() const = 0;
+
+    // 终止进程及其启动的全部子孙进程，可重复调用
+    virtual void killTree() = 0;
+
+    // 进程退出后在后端线程上调用 onExit 一次；每个进程只能注册一次。
+    // 与 spawn 分开，调用方可以先保存好进程对象再开始等待
+    virtual void waitForExit(ExitCallback onExit) = 0;
+};
+
+class IProcessBackend {
+public:
+    virtual ~IProcessBackend() = default;
+
+    // 启动失败时返回 nullptr，并在 error 中给出可直接写入日志的原因
+    virtual std::unique_ptr<IProcess> spawn(const SpawnSpec& spec, std::string& error) = 0;
+
+    // pid 的直接子进程，不含控制台宿主等系统辅助进程
+    virtual std::vector<uint32_t> listChildren(uint32_t pid) = 0;
+};
@@ -1,82 +1,692 @@
 // SimpleJson.hpp - Lightweight header-only JSON parser/writer for ProcessManager
 // Supports: objects, arrays, strings, booleans, numbers, null
+// 对象成员保持插入顺序（解析时即原文顺序），序列化时按该顺序输出
+// 所有容器与字符串基于 std::pmr，配合 sj::Document 可整棵树从同一块 arena 分配；
+// sj::Value 为 16 字节的标记联合，短字符串内联、容器装箱
+// 另提供原位解析模式 parse_insitu：无转义的字符串直接引用输入缓冲区，不做拷贝；
+// 以及不构建 DOM 的流式拉取解析器 sj::Reader、按需访问的 sj::Lazy、结构体字段绑定 SJ_FIELDS
 #pragma once
 #include <string>
+#include <string_view>
+#include <memory_resource>
 #include <vector>
-#include <map>
 #include <variant>
 #include <stdexcept>
-#include <sstream>
-#include <iomanip>
 #include <algorithm>
 #include <functional>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <istream>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 字符串扫描的向量化实现：编译器开启 AVX2（/arch:AVX2）时每次处理 32 字节，
+// x64 默认可用 SSE2 时每次 16 字节，其余平台回退到逐字节扫描
+#if defined(__AVX2__)
+#define SJ_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SJ_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(SJ_SIMD_SSE2) || defined(SJ_SIMD_AVX2))
+#include <intrin.h>
+#endif
 
 namespace sj {
 
+using String = std::pmr::string;
+
+namespace detail {
+
+// 递归解析的最大嵌套深度，防止恶意输入耗尽栈空间
+constexpr int kMaxDepth = 256;
+
+// 十六进制字符转数值，非法字符返回 -1
+inline int hexDigit(char h) {
+    if (h >= '0' && h <= '9') return h - '0';
+    if (h >= 'a' && h <= 'f') return h - 'a' + 10;
+    if (h >= 'A' && h <= 'F') return h - 'A' + 10;
+    return -1;
+}
+
+// 整数 v 在 T 的取值范围内时写入 out，否则返回 false
+template <class T>
+inline bool narrowTo(int64_t v, T& out) {
+    if constexpr (std::is_signed_v<T>) {
+        if (v < (int64_t)std::numeric_limits<T>::min() || v > (int64_t)std::numeric_limits<T>::max()) return false;
+    } else {
+        if (v < 0 || (uint64_t)v > (uint64_t)std::numeric_limits<T>::max()) return false;
+    }
+    out = (T)v;
+    return true;
+}
+
+// 浮点数 d 截断取整后在 T 的取值范围内时写入 out；NaN、无穷与越界返回 false。
+// 越界时直接 (T)d 是未定义行为
+template <class T>
+inline bool truncateTo(double d, T& out) {
+    const double lo = (double)std::numeric_limits<T>::min();                    // 0 或 -2^(n-1)，可精确表示
+    const double hi = 2.0 * (double)((std::numeric_limits<T>::max() >> 1) + 1); // 2^n 或 2^(n-1)，不含
+    double t = std::trunc(d);
+    if (!(t >= lo && t < hi)) return false;
+    out = (T)t;
+    return true;
+}
+
+// 超出 int64 范围时取最近的端点，NaN 取 0
+inline int64_t saturateInt64(double d) {
+    int64_t v;
+    if (truncateTo(d, v)) return v;
+    if (d != d) return 0;
+    return d < 0 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+}
+
+// 读取拉取解析器（Reader / msgpack::Unpacker）当前 Number 事件的整数值；超出 T 的范围时返回 false
+template <class R, class T>
+inline bool readInteger(const R& r, T& out) {
+    return r.is_integer() ? narrowTo(r.integer(), out) : truncateTo(r.number(), out);
+}
+
+inline unsigned ctz32(uint32_t m) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, m);
+    return (unsigned)idx;
+#else
+    return (unsigned)__builtin_ctz(m);
+#endif
+}
+
+// 返回 [p, end) 中第一个 '"' 或 '\\' 的位置；withCtrl 为 true 时控制字符（< 0x20）也会命中。
+// 找不到时返回 end
+template <bool withCtrl>
+inline const char* scanSpecial(const char* p, const char* end) {
+#if defined(SJ_SIMD_AVX2)
+    const __m256i q32 = _mm256_set1_epi8('"');
+    const __m256i b32 = _mm256_set1_epi8('\\');
+    const __m256i c32 = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(x, q32), _mm256_cmpeq_epi8(x, b32));
+        if (withCtrl)  // x <= 0x1F  <=>  max(x, 0x1F) == 0x1F（无符号比较）
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(x, c32), c32));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+        if (mask) return p + ctz32(mask);
+        p += 32;
+    }
+#endif
+#if defined(SJ_SIMD_SSE2)
+    const __m128i q16 = _mm_set1_epi8('"');
+    const __m128i b16 = _mm_set1_epi8('\\');
+    const __m128i c16 = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x, q16), _mm_cmpeq_epi8(x, b16));
+        if (withCtrl)
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(x, c16), c16));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask) return p + ctz32(mask);
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\' || (withCtrl && c < 0x20)) return p;
+    }
+    return end;
+}
+
+// 将 BMP 码点以 UTF-8 追加到 s
+template <class Str>
+inline void appendUtf8(Str& s, unsigned int cp) {
+    if (cp < 0x80) s += (char)cp;
+    else if (cp < 0x800) {
+        s += (char)(0xC0 | (cp >> 6));
+        s += (char)(0x80 | (cp & 0x3F));
+    } else {
+        s += (char)(0xE0 | (cp >> 12));
+        s += (char)(0x80 | ((cp >> 6) & 0x3F));
+        s += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace detail
+
+// ─── 键驻留 ─────────────────────────────────────────────────────────────────
+// 对象键在 KeyPool 中只存一份：同一池中内容相同的键指向同一个 InternedKey，
+// 因此对象内的键比较退化为指针比较，成百上千个进程对象共享同一组 "id"/"name"/... 键。
+// 每个 Document 自带一个从其 arena 分配的池，随文档一起释放。
+// 不属于任何 Document 的对象（sj::parse 的结果、拷贝、msgpack::decode 默认）不使用池：
+// 键若在全局键表 GlobalKeys 中（SJ_FIELDS 声明的成员名等编译期已知的键）直接引用表中的副本，
+// 否则由对象自己分配并在析构时释放，不会在进程内无限累积
+struct InternedKey {
+    size_t   hash;
+    uint32_t len;
+    uint32_t owned;   // 非 0 表示由所在对象独占，随对象释放；池与全局键表中的键为 0
+    const char*      data() const { return reinterpret_cast<const char*>(this + 1); }
+    std::string_view view() const { return std::string_view(data(), len); }
+};
+
+namespace detail {
+
+inline size_t hashKey(std::string_view k) {
+    uint64_t h = 1469598103934665603ull;            // FNV-1a
+    for (unsigned char c : k) { h ^= c; h *= 1099511628211ull; }
+    return (size_t)h;
+}
+
+inline InternedKey* makeKey(std::pmr::memory_resource* mr, std::string_view k, size_t h, bool owned) {
+    if (k.size() > UINT32_MAX) throw std::length_error("sj: object key too long");
+    void* mem = mr->allocate(sizeof(InternedKey) + k.size() + 1, alignof(InternedKey));
+    auto* e = new (mem) InternedKey{ h, (uint32_t)k.size(), owned ? 1u : 0u };
+    char* chars = reinterpret_cast<char*>(e + 1);
+    std::memcpy(chars, k.data(), k.size());
+    chars[k.size()] = '\0';
+    return e;
+}
+
+inline void freeKey(std::pmr::memory_resource* mr, const InternedKey* k) {
+    mr->deallocate(const_cast<InternedKey*>(k), sizeof(InternedKey) + k->len + 1, alignof(InternedKey));
+}
+
+} // namespace detail
+
+// 单个 Document 的驻留池。与 arena 一样不加锁，只在持有文档的线程上使用
+class KeyPool {
+public:
+    explicit KeyPool(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : m_mr(mr), m_slots(mr) {}
+    KeyPool(const KeyPool&)            = delete;
+    KeyPool& operator=(const KeyPool&) = delete;
+    ~KeyPool() {
+        for (const InternedKey* k : m_slots)
+            if (k) detail::freeKey(m_mr, k);
+    }
+
+    // 返回 k 的驻留副本，不存在时插入
+    const InternedKey* intern(std::string_view k) {
+        size_t h = detail::hashKey(k);
+        size_t slot = 0;
+        if (!m_slots.empty()) {
+            slot = probe(k, h);
+            if (m_slots[slot]) return m_slots[slot];
+        }
+        if ((m_count + 1) * 2 > m_slots.size()) {
+            grow();
+            slot = probe(k, h);
+        }
+        m_slots[slot] = detail::makeKey(m_mr, k, h, false);
+        ++m_count;
+        return m_slots[slot];
+    }
+
+    // 仅查找不插入；池中没有的键必然不在任何使用该池的对象中
+    const InternedKey* find(std::string_view k) const {
+        if (m_slots.empty()) return nullptr;
+        return m_slots[probe(k, detail::hashKey(k))];
+    }
+
+    size_t size() const { return m_count; }
+
+private:
+    std::pmr::memory_resource*             m_mr;
+    std::pmr::vector<const InternedKey*>   m_slots;   // 开放寻址，容量为 2 的幂，装载因子不超过 0.5
+    size_t                                 m_count = 0;
+
+    // 返回 k 所在槽位或应插入的空槽
+    size_t probe(std::string_view k, size_t h) const {
+        size_t mask = m_slots.size() - 1;
+        size_t slot = h & mask;
+        while (m_slots[slot] && (m_slots[slot]->hash != h || m_slots[slot]->view() != k))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void grow() {
+        std::pmr::vector<const InternedKey*> old(std::move(m_slots), m_mr);
+        m_slots.assign(old.empty() ? 64 : old.size() * 2, nullptr);
+        size_t mask = m_slots.size() - 1;
+        for (const InternedKey* k : old) {
+            if (!k) continue;
+            size_t slot = k->hash & mask;
+            while (m_slots[slot]) slot = (slot + 1) & mask;
+            m_slots[slot] = k;
+        }
+    }
+};
+
+// 进程内共享的全局键表：只收录程序登记的键，SJ_FIELDS 在静态初始化时登记各成员名。
+// 固定容量、只增不删，查找不加锁（槽位以 release / acquire 发布），登记时加锁；
+// 表满后不再收录，对象改为自行保存键
+class GlobalKeys {
+public:
+    static GlobalKeys& instance() {
+        static GlobalKeys keys;
+        return keys;
+    }
+
+    const InternedKey* find(std::string_view k) const { return find(k, detail::hashKey(k)); }
+
+    const InternedKey* find(std::string_view k, size_t h) const {
+        for (size_t i = 0, slot = h & kMask; i < kSlots; ++i, slot = (slot + 1) & kMask) {
+            const InternedKey* e = m_slots[slot].load(std::memory_order_acquire);
+            if (!e) return nullptr;
+            if (e->hash == h && e->view() == k) return e;
+        }
+        return nullptr;
+    }
+
+    // 登记 k 并返回表中的副本；表已满时返回 nullptr
+    const InternedKey* add(std::string_view k) {
+        size_t h = detail::hashKey(k);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (const InternedKey* e = find(k, h)) return e;
+        if ((m_count + 1) * 2 > kSlots) return nullptr;   // 装载因子不超过 0.5
+        size_t slot = h & kMask;
+        while (m_slots[slot].load(std::memory_order_relaxed)) slot = (slot + 1) & kMask;
+        const InternedKey* e = detail::makeKey(std::pmr::new_delete_resource(), k, h, false);
+        m_slots[slot].store(e, std::memory_order_release);
+        ++m_count;
+        return e;
+    }
+
+    size_t size() const { return m_count; }
+
+private:
+    static constexpr size_t kSlots = 4096;
+    static constexpr size_t kMask  = kSlots - 1;
+
+    GlobalKeys() = default;
+    ~GlobalKeys() {
+        for (auto& s : m_slots)
+            if (const InternedKey* e = s.load(std::memory_order_relaxed)) detail::freeKey(std::pmr::new_delete_resource(), e);
+    }
+
+    std::atomic<const InternedKey*> m_slots[kSlots] = {};
+    size_t                          m_count = 0;   // 受 m_mutex 保护
+    std::mutex                      m_mutex;
+};
+
+// 对象键的句柄，可隐式转换为 std::string_view。同一池中的键按指针比较；
+// 不同来源的键（如独立对象各自保存的键）指针不同时再比较内容
+class Key {
+public:
+    explicit Key(const InternedKey* k) : m_k(k) {}
+
+    std::string_view view() const { return m_k->view(); }
+    operator std::string_view() const { return m_k->view(); }
+    const char* data()  const { return m_k->data(); }
+    const char* c_str() const { return m_k->data(); }
+    size_t      size()  const { return m_k->len; }
+    size_t      hash()  const { return m_k->hash; }
+    const InternedKey* interned() const { return m_k; }
+
+    friend bool operator==(Key a, Key b) {
+        return a.m_k == b.m_k || (a.m_k->hash == b.m_k->hash && a.view() == b.view());
+    }
+    friend bool operator!=(Key a, Key b) { return !(a == b); }
+    friend bool operator==(Key a, std::string_view b) { return a.view() == b; }
+    friend bool operator==(std::string_view a, Key b) { return a == b.view(); }
+    friend bool operator!=(Key a, std::string_view b) { return a.view() != b; }
+    friend bool operator!=(std::string_view a, Key b) { return a != b.view(); }
+
+private:
+    const InternedKey* m_k;
+};
+
+// ─── 扁平对象 ───────────────────────────────────────────────────────────────
+// 按插入顺序保存键值对的连续数组，替代 std::map 的红黑树节点。
+// 使用 KeyPool 时键为池中的驻留键：查找先在池中定位键（池中不存在即可直接判定缺失），
+// 之后只做指针比较；不使用池的独立对象按预存哈希与内容比较。成员数不超过 kIndexThreshold
+// 时线性比较；超过后额外维护一张以键的预存哈希为下标的开放寻址索引。
+// 只读查找（find / at / contains / count）从不插入键，operator[] 只在新增成员时才驻留键
+template <class V>
+class FlatObject {
+public:
+    using value_type     = std::pair<Key, V>;
+    using container      = std::pmr::vector<value_type>;
+    using iterator       = typename container::iterator;
+    using const_iterator = typename container::const_iterator;
+
+    static constexpr size_t kIndexThreshold = 8;
+    static constexpr size_t npos = (size_t)-1;
+
+    FlatObject() = default;
+    // 成员数组与哈希索引从 mr 分配；keys 为空时为独立对象，键按上文规则保存
+    explicit FlatObject(std::pmr::memory_resource* mr, KeyPool* keys = nullptr)
+        : m_items(mr), m_index(mr), m_keys(keys) {}
+
+    // 拷贝总是落在默认内存资源上的独立对象，可独立于来源 Document 存活
+    FlatObject(const FlatObject& o) {
+        m_items.reserve(o.m_items.size());
+        for (const auto& kv : o.m_items) m_items.emplace_back(adopt(o, kv.first), kv.second);
+        m_index.assign(o.m_index.begin(), o.m_index.end());   // 索引只依赖下标与哈希，与键的来源无关
+    }
+    FlatObject(FlatObject&& o) noexcept
+        : m_items(std::move(o.m_items)), m_index(std::move(o.m_index)), m_keys(o.m_keys) {
+        o.m_items.clear();
+        o.m_index.clear();
+    }
+    // 内存资源相同时交换缓冲区；不同时（如 Document 中的对象被赋予默认资源上的拷贝）
+    // std::pmr::vector 不允许交换，逐个成员移入本对象的资源，键改驻留到本对象的池
+    FlatObject& operator=(FlatObject o) {
+        if (m_items.get_allocator() == o.m_items.get_allocator()) {
+            m_items.swap(o.m_items);
+            m_index.swap(o.m_index);
+            std::swap(m_keys, o.m_keys);
+            return *this;
+        }
+        clear();
+        m_items.reserve(o.m_items.size());
+        for (auto& kv : o.m_items) m_items.emplace_back(adopt(o, kv.first), std::move(kv.second));
+        rebuildIndex();
+        return *this;
+    }
+    ~FlatObject() { releaseKeys(); }
+
+    std::pmr::memory_resource* resource() const { return m_items.get_allocator().resource(); }
+    KeyPool*                   keys()     const { return m_keys; }
+
+    iterator       begin()       { return m_items.begin(); }
+    iterator       end()         { return m_items.end(); }
+    const_iterator begin() const { return m_items.begin(); }
+    const_iterator end()   const { return m_items.end(); }
+    size_t size()  const { return m_items.size(); }
+    bool   empty() const { return m_items.empty(); }
+    void   reserve(size_t n) { m_items.reserve(n); }
+    void   clear() { releaseKeys(); m_items.clear(); m_index.clear(); }
+
+    // 不存在时按插入顺序追加
+    V& operator[](std::string_view key) {
+        size_t h = detail::hashKey(key);
+        size_t i = lookup(key, h);
+        if (i != npos) return m_items[i].second;
+        return append(makeKey(key, h));
+    }
+
+    V& at(std::string_view key) {
+        size_t i = lookup(key);
+        if (i == npos) throw std::out_of_range("sj::Object::at: key not found");
+        return m_items[i].second;
+    }
+    const V& at(std::string_view key) const {
+        size_t i = lookup(key);
+        if (i == npos) throw std::out_of_range("sj::Object::at: key not found");
+        return m_items[i].second;
+    }
+
+    iterator find(std::string_view key) {
+        size_t i = lookup(key);
+        return i == npos ? end() : begin() + i;
+    }
+    const_iterator find(std::string_view key) const {
+        size_t i = lookup(key);
+        return i == npos ? end() : begin() + i;
+    }
+    size_t count(std::string_view key)    const { return lookup(key) != npos ? 1 : 0; }
+    bool   contains(std::string_view key) const { return lookup(key) != npos; }
+
+    // 删除后保持其余成员的相对顺序
+    size_t erase(std::string_view key) {
+        size_t i = lookup(key);
+        if (i == npos) return 0;
+        const InternedKey* k = m_items[i].first.interned();
+        m_items.erase(m_items.begin() + i);
+        if (k->owned) detail::freeKey(resource(), k);
+        rebuildIndex();
+        return 1;
+    }
+
+private:
+    container                  m_items;
+    std::pmr::vector<uint32_t> m_index;   // 槽位存放 下标+1，0 表示空槽；容量为 2 的幂
+    KeyPool*                   m_keys = nullptr;
+
+    // 新增成员的键：有池时驻留到池中；否则优先引用全局键表，不在表中时由本对象分配
+    const InternedKey* makeKey(std::string_view key, size_t h) {
+        if (m_keys) return m_keys->intern(key);
+        if (const InternedKey* g = GlobalKeys::instance().find(key, h)) return g;
+        return detail::makeKey(resource(), key, h, true);
+    }
+
+    // 从对象 o 转入本对象的键：同一个池或全局键表中的键直接共用，其余按本对象的规则重新生成
+    Key adopt(const FlatObject& o, Key k) {
+        if ((m_keys && o.m_keys == m_keys) || (!m_keys && !k.interned()->owned && !o.m_keys)) return k;
+        return Key(makeKey(k.view(), k.hash()));
+    }
+
+    void releaseKeys() {
+        if (m_keys) return;
+        for (const auto& kv : m_items)
+            if (kv.first.interned()->owned) detail::freeKey(resource(), kv.first.interned());
+    }
+
+    size_t lookup(std::string_view key) const { return lookup(key, detail::hashKey(key)); }
+
+    size_t lookup(std::string_view key, size_t h) const {
+        if (m_keys) {
+            const InternedKey* k = m_keys->find(key);
+            return k ? lookup(k) : npos;
+        }
+        auto same = [&](const InternedKey* k) { return k->hash == h && k->view() == key; };
+        if (m_index.empty()) {
+            for (size_t i = 0; i < m_items.size(); ++i)
+                if (same(m_items[i].first.interned())) return i;
+            return npos;
+        }
+        size_t mask = m_index.size() - 1;
+        for (size_t slot = h & mask; m_index[slot]; slot = (slot + 1) & mask) {
+            size_t i = m_index[slot] - 1;
+            if (same(m_items[i].first.interned())) return i;
+        }
+        return npos;
+    }
+
+    // 池中的键按指针比较
+    size_t lookup(const InternedKey* k) const {
+        if (m_index.empty()) {
+            for (size_t i = 0; i < m_items.size(); ++i)
+                if (m_items[i].first.interned() == k) return i;
+            return npos;
+        }
+        size_t mask = m_index.size() - 1;
+        for (size_t slot = k->hash & mask; m_index[slot]; slot = (slot + 1) & mask) {
+            size_t i = m_index[slot] - 1;
+            if (m_items[i].first.interned() == k) return i;
+        }
+        return npos;
+    }
+
+    void insertIndex(size_t i) {
+        size_t mask = m_index.size() - 1;
+        size_t slot = m_items[i].first.hash() & mask;
+        while (m_index[slot]) slot = (slot + 1) & mask;
+        m_index[slot] = (uint32_t)(i + 1);
+    }
+
+    void rebuildIndex() {
+        m_index.clear();
+        if (m_items.size() <= kIndexThreshold) return;
+        size_t cap = 16;
+        while (cap < m_items.size() * 2) cap <<= 1;   // 装载因子不超过 0.5
+        m_index.assign(cap, 0);
+        for (size_t i = 0; i < m_items.size(); ++i) insertIndex(i);
+    }
+
+    V& append(const InternedKey* k) {
+        m_items.emplace_back(std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple());
+        size_t n = m_items.size();
+        if (n > kIndexThreshold) {
+            if (m_index.empty() || n * 2 > m_index.size()) rebuildIndex();
+            else insertIndex(n - 1);
+        }
+        return m_items.back().second;
+    }
+};
+
 struct Value;
-using Object = std::map<std::string, Value>;
-using Array  = std::vector<Value>;
+using Object = FlatObject<Value>;
+using Array  = std::pmr::vector<Value>;
 using Null   = std::monostate;
 
+namespace detail {
+
+// 长字符串的堆块：头部记录所属内存资源与长度，字符紧随其后（以 '\0' 结尾）
+struct HeapStr {
+    std::pmr::memory_resource* mr;
+    size_t                     len;
+    const char* chars() const { return reinterpret_cast<const char*>(this + 1); }
+    char*       chars()       { return reinterpret_cast<char*>(this + 1); }
+};
+
+} // namespace detail
+
+// ─── Value ───────────────────────────────────────────────────────────────────
+// 16 字节的紧凑标记表示，每个节点的大小与所存类型无关：
+//   [0, 8)   bool / int64 / double，或指向堆字符串、视图字符串、装箱 Object / Array 的指针
+//   [8, 12)  视图字符串的长度
+//   [0, 14)  短字符串（不超过 kSmallMax 字节）直接内联，[14] 为其长度
+//   [15]     类型标记
+// 长字符串与容器从构造时指定的内存资源分配（Document 中即 arena）。
+// 拷贝为深拷贝且总是分配在默认内存资源上，可安全地活得比来源 Document 更久；移动只转移指针
 struct Value {
-    std::variant<Null, bool, double, std::string, Object, Array> data;
-
-    Value()                        : data(Null{}) {}
-    Value(std::nullptr_t)          : data(Null{}) {}
-    Value(bool v)                  : data(v) {}
-    Value(int v)                   : data((double)v) {}
-    Value(long long v)             : data((double)v) {}
-    Value(double v)                : data(v) {}
-    Value(const char* v)           : data(std::string(v)) {}
-    Value(const std::string& v)    : data(v) {}
-    Value(std::string&& v)         : data(std::move(v)) {}
-    Value(const Object& v)         : data(v) {}
-    Value(Object&& v)              : data(std::move(v)) {}
-    Value(const Array& v)          : data(v) {}
-    Value(Array&& v)               : data(std::move(v)) {}
-
-    bool is_null()   const { return std::holds_alternative<Null>(data); }
-    bool is_bool()   const { return std::holds_alternative<bool>(data); }
-    bool is_number() const { return std::holds_alternative<double>(data); }
-    bool is_string() const { return std::holds_alternative<std::string>(data); }
-    bool is_object() const { return std::holds_alternative<Object>(data); }
-    bool is_array()  const { return std::holds_alternative<Array>(data); }
-
-    bool        get_bool()   const { return std::get<bool>(data); }
-    double      get_number() const { return std::get<double>(data); }
-    int         get_int()    const { return (int)std::get<double>(data); }
-    const std::string& get_string() const { return std::get<std::string>(data); }
-    std::string& get_string()       { return std::get<std::string>(data); }
-    const Object& get_object() const { return std::get<Object>(data); }
-    Object&       get_object()       { return std::get<Object>(data); }
-    const Array&  get_array()  const { return std::get<Array>(data); }
-    Array&        get_array()        { return std::get<Array>(data); }
+    static constexpr size_t kSmallMax = 14;
+
+    Value() noexcept               { setTag(Tag::Null); }
+    Value(std::nullptr_t) noexcept { setTag(Tag::Null); }
+    Value(bool v) noexcept         { store(v); setTag(Tag::Bool); }
+    Value(int v) noexcept          { setInt(v); }
+    Value(long v) noexcept         { setInt(v); }
+    Value(long long v) noexcept    { setInt(v); }
+    Value(unsigned v) noexcept     { setInt(v); }
+    Value(unsigned long v) noexcept {
+        if ((unsigned long long)v <= (unsigned long long)INT64_MAX) setInt((int64_t)v);
+        else setDouble((double)v);
+    }
+    Value(unsigned long long v) noexcept {
+        if (v <= (unsigned long long)INT64_MAX) setInt((int64_t)v);
+        else setDouble((double)v);
+    }
+    Value(double v) noexcept       { setDouble(v); }
+    Value(const char* v)           { initString(v, std::pmr::get_default_resource()); }
+    Value(const std::string& v)    { initString(v, std::pmr::get_default_resource()); }
+    Value(const String& v)         { initString(v, std::pmr::get_default_resource()); }
+    Value(String&& v)              { initString(v, v.get_allocator().resource()); }
+    // 字符串拷贝到指定内存资源（通常为 Document 的 arena）
+    Value(std::string_view v, std::pmr::memory_resource* mr) { initString(v, mr); }
+    Value(const Object& v)         { boxObject(Object(v)); }
+    Value(Object&& v)              { boxObject(std::move(v)); }
+    Value(const Array& v)          { boxArray(Array(v)); }
+    Value(Array&& v)               { boxArray(std::move(v)); }
+
+    Value(const Value& o) {
+        switch (o.tag()) {
+        case Tag::Heap:   initString(o.get_string_view(), std::pmr::get_default_resource()); break;
+        case Tag::Object: boxObject(Object(o.get_object())); break;
+        case Tag::Array:  boxArray(Array(o.get_array())); break;
+        default:          std::memcpy(m_buf, o.m_buf, sizeof(m_buf)); break;
+        }
+    }
+    Value(Value&& o) noexcept {
+        std::memcpy(m_buf, o.m_buf, sizeof(m_buf));
+        o.setTag(Tag::Null);
+    }
+    Value& operator=(Value o) noexcept {
+        unsigned char tmp[sizeof(m_buf)];
+        std::memcpy(tmp, m_buf, sizeof(m_buf));
+        std::memcpy(m_buf, o.m_buf, sizeof(m_buf));
+        std::memcpy(o.m_buf, tmp, sizeof(m_buf));
+        return *this;
+    }
+    ~Value() { destroy(); }
+
+    // 构造引用外部内存的字符串值（不拷贝）
+    static Value view(std::string_view v) {
+        Value r;
+        r.store(v.data());
+        r.store((uint32_t)v.size(), 8);
+        r.setTag(Tag::View);
+        return r;
+    }
+
+    bool is_null()   const { return tag() == Tag::Null; }
+    bool is_bool()   const { return tag() == Tag::Bool; }
+    bool is_number() const { return tag() == Tag::Double || is_int(); }
+    bool is_int()    const { return tag() == Tag::Int; }
+    bool is_string() const { return tag() == Tag::Small || tag() == Tag::Heap || is_view(); }
+    bool is_view()   const { return tag() == Tag::View; }
+    bool is_object() const { return tag() == Tag::Object; }
+    bool is_array()  const { return tag() == Tag::Array; }
+
+    // 类型不符时抛出 std::runtime_error
+    bool        get_bool()   const { expect(is_bool()); return load<bool>(); }
+    double      get_number() const {
+        if (is_int()) return (double)load<int64_t>();
+        expect(tag() == Tag::Double);
+        return load<double>();
+    }
+    // 浮点数取截断值；非数值或超出目标类型的范围时同样视为类型不符
+    int64_t     get_int64()  const { int64_t v = 0; expect(toInt(v)); return v; }
+    int         get_int()    const { int v = 0;     expect(toInt(v)); return v; }
+    // 字符串内容只读；视图的生命周期跟随 Value（短字符串内联在 Value 中）
+    std::string_view get_string() const { return get_string_view(); }
+    std::string_view get_string_view() const {
+        switch (tag()) {
+        case Tag::Small: return std::string_view((const char*)m_buf, m_buf[kSmallMax]);
+        case Tag::Heap: {
+            auto* h = load<detail::HeapStr*>();
+            return std::string_view(h->chars(), h->len);
+        }
+        case Tag::View:  return std::string_view(load<const char*>(), load<uint32_t>(8));
+        default: expect(false); return {};
+        }
+    }
+    const Object& get_object() const { expect(is_object()); return *load<Object*>(); }
+    Object&       get_object()       { expect(is_object()); return *load<Object*>(); }
+    const Array&  get_array()  const { expect(is_array());  return *load<Array*>(); }
+    Array&        get_array()        { expect(is_array());  return *load<Array*>(); }
 
     // operator[] for object
-    Value& operator[](const std::string& key) {
-        if (is_null()) data = Object{};
-        return std::get<Object>(data)[key];
+    Value& operator[](std::string_view key) {
+        if (is_null()) *this = Value(Object{});
+        return get_object()[key];
     }
-    const Value& operator[](const std::string& key) const {
-        return std::get<Object>(data).at(key);
+    const Value& operator[](std::string_view key) const {
+        return get_object().at(key);
     }
-    bool contains(const std::string& key) const {
+    bool contains(std::string_view key) const {
         if (!is_object()) return false;
-        return get_object().count(key) > 0;
+        return get_object().contains(key);
     }
     // operator[] for array
-    Value& operator[](size_t idx)       { return std::get<Array>(data)[idx]; }
-    const Value& operator[](size_t idx) const { return std::get<Array>(data)[idx]; }
+    Value& operator[](size_t idx)       { return get_array()[idx]; }
+    const Value& operator[](size_t idx) const { return get_array()[idx]; }
     size_t size() const {
         if (is_array())  return get_array().size();
         if (is_object()) return get_object().size();
         return 0;
     }
-    void push_back(Value v) { std::get<Array>(data).push_back(std::move(v)); }
+    void push_back(Value v) { get_array().push_back(std::move(v)); }
+
+    // 将树中所有视图字符串转为自有字符串，之后可安全释放原输入缓冲区
+    void own() {
+        if (is_view()) { *this = Value(get_string_view(), std::pmr::get_default_resource()); return; }
+        if (is_array())  for (auto& v : get_array())  v.own();
+        if (is_object()) for (auto& kv : get_object()) kv.second.own();
+    }
 
     // Convenience: get with default
     std::string get_string_or(const std::string& def) const {
-        if (is_string()) return get_string();
+        if (is_string()) return std::string(get_string_view());
         return def;
     }
     bool get_bool_or(bool def) const {
@@ -84,84 +694,265 @@ struct Value {
         return def;
     }
     int get_int_or(int def) const {
-        if (is_number()) return get_int();
-        return def;
+        int v;
+        return toInt(v) ? v : def;
+    }
+    int64_t get_int64_or(int64_t def) const {
+        int64_t v;
+        return toInt(v) ? v : def;
     }
     double get_number_or(double def) const {
         if (is_number()) return get_number();
         return def;
     }
+
+private:
+    enum class Tag : unsigned char { Null, Bool, Int, Double, Small, Heap, View, Object, Array };
+
+    alignas(8) unsigned char m_buf[16];
+
+    Tag  tag() const      { return (Tag)m_buf[15]; }
+    void setTag(Tag t)    { m_buf[15] = (unsigned char)t; }
+    // 经 memcpy 读写负载，避免类型双关；编译器会将其优化为普通的加载 / 存储
+    template <class T> T load(size_t off = 0) const { T v; std::memcpy(&v, m_buf + off, sizeof(T)); return v; }
+    template <class T> void store(T v, size_t off = 0) { std::memcpy(m_buf + off, &v, sizeof(T)); }
+
+    static void expect(bool ok) {
+        if (!ok) throw std::runtime_error("sj::Value: type mismatch");
+    }
+
+    template <class T>
+    bool toInt(T& out) const {
+        if (is_int()) return detail::narrowTo(load<int64_t>(), out);
+        if (tag() == Tag::Double) return detail::truncateTo(load<double>(), out);
+        return false;
+    }
+
+    void setInt(int64_t v)   { store(v); setTag(Tag::Int); }
+    void setDouble(double v) { store(v); setTag(Tag::Double); }
+
+    void initString(std::string_view s, std::pmr::memory_resource* mr) {
+        if (s.size() <= kSmallMax) {
+            std::memcpy(m_buf, s.data(), s.size());
+            m_buf[kSmallMax] = (unsigned char)s.size();
+            setTag(Tag::Small);
+            return;
+        }
+        void* mem = mr->allocate(sizeof(detail::HeapStr) + s.size() + 1, alignof(detail::HeapStr));
+        auto* h = new (mem) detail::HeapStr{ mr, s.size() };
+        std::memcpy(h->chars(), s.data(), s.size());
+        h->chars()[s.size()] = '\0';
+        store(h);
+        setTag(Tag::Heap);
+    }
+
+    // 容器装箱到其自身的内存资源上
+    void boxObject(Object&& o) {
+        std::pmr::memory_resource* mr = o.resource();
+        store(new (mr->allocate(sizeof(Object), alignof(Object))) Object(std::move(o)));
+        setTag(Tag::Object);
+    }
+    void boxArray(Array&& a) {
+        std::pmr::memory_resource* mr = a.get_allocator().resource();
+        store(new (mr->allocate(sizeof(Array), alignof(Array))) Array(std::move(a)));
+        setTag(Tag::Array);
+    }
+
+    void destroy() noexcept {
+        switch (tag()) {
+        case Tag::Heap: {
+            auto* h = load<detail::HeapStr*>();
+            h->mr->deallocate(h, sizeof(detail::HeapStr) + h->len + 1, alignof(detail::HeapStr));
+            break;
+        }
+        case Tag::Object: {
+            Object* o = load<Object*>();
+            std::pmr::memory_resource* mr = o->resource();
+            o->~Object();
+            mr->deallocate(o, sizeof(Object), alignof(Object));
+            break;
+        }
+        case Tag::Array: {
+            Array* a = load<Array*>();
+            std::pmr::memory_resource* mr = a->get_allocator().resource();
+            a->~Array();
+            mr->deallocate(a, sizeof(Array), alignof(Array));
+            break;
+        }
+        default: break;
+        }
+    }
 };
 
+static_assert(sizeof(Value) == 16, "sj::Value must stay 16 bytes");
+
 // ─── Serializer ─────────────────────────────────────────────────────────────
-static inline std::string escapeString(const std::string& s) {
-    std::ostringstream oss;
-    oss << '"';
-    for (unsigned char c : s) {
+// 将 s 转义后追加到 out（含首尾引号）；无需转义的连续片段整段拷贝
+static inline void escapeStringTo(std::string& out, std::string_view s) {
+    static const char hexDigits[] = "0123456789abcdef";
+    const char* p   = s.data();
+    const char* end = p + s.size();
+    out += '"';
+    while (p < end) {
+        const char* hit = detail::scanSpecial<true>(p, end);
+        out.append(p, hit);
+        if (hit == end) break;
+        unsigned char c = (unsigned char)*hit;
         switch (c) {
-        case '"':  oss << "\\\""; break;
-        case '\\': oss << "\\\\"; break;
-        case '\n': oss << "\\n";  break;
-        case '\r': oss << "\\r";  break;
-        case '\t': oss << "\\t";  break;
-        default:
-            if (c < 0x20) oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c;
-            else oss << c;
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\r': out += "\\r";  break;
+        case '\t': out += "\\t";  break;
+        default: {
+            char u[6] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF] };
+            out.append(u, 6);
         }
+        }
+        p = hit + 1;
     }
-    oss << '"';
-    return oss.str();
+    out += '"';
+}
+
+static inline std::string escapeString(std::string_view s) {
+    std::string out;
+    out.reserve(s.size() + 2);
+    escapeStringTo(out, s);
+    return out;
 }
 
+// ─── Writer ──────────────────────────────────────────────────────────────────
+// 直接向调用方提供的 std::string 追加 JSON 文本，缓冲区可跨调用复用以避免反复分配。
+// compact 模式不输出任何空白；pretty 模式与 stringify 的缩进格式一致。用法：
+//     m_buf.clear();
+//     sj::Writer w(m_buf);
+//     w.startObject().key("id").value(id).key("pid").value(pid).endObject();
+class Writer {
+public:
+    explicit Writer(std::string& out, bool pretty = false, int step = 2, int baseIndent = 0)
+        : m_out(out), m_pretty(pretty), m_step(step), m_base(baseIndent) {}
+
+    Writer& startObject() { prefix(); m_out += '{'; m_levels.push_back(0); return *this; }
+    Writer& endObject()   { close('}'); return *this; }
+    Writer& startArray()  { prefix(); m_out += '['; m_levels.push_back(0); return *this; }
+    Writer& endArray()    { close(']'); return *this; }
+
+    Writer& key(std::string_view k) {
+        prefix();
+        escapeStringTo(m_out, k);
+        if (m_pretty) m_out += ": ";
+        else          m_out += ':';
+        m_afterKey = true;
+        return *this;
+    }
+
+    Writer& null()                   { prefix(); m_out += "null"; return *this; }
+    Writer& value(std::nullptr_t)    { return null(); }
+    Writer& value(bool b)            { prefix(); m_out += b ? "true" : "false"; return *this; }
+    Writer& value(int n)             { return value((long long)n); }
+    Writer& value(unsigned n)        { return value((unsigned long long)n); }
+    Writer& value(long n)            { return value((long long)n); }
+    Writer& value(unsigned long n)   { return value((unsigned long long)n); }
+    // 无符号数按自身类型输出：超过 INT64_MAX 的值转为 long long 会变成负数
+    Writer& value(unsigned long long n) { return integer(n); }
+    Writer& value(long long n)          { return integer(n); }
+    // 非整数以最短且可精确往返的形式输出（std::to_chars 默认格式）
+    Writer& value(double d) {
+        // 整数值的浮点数按整数输出；NaN / Inf 在 JSON 中无表示，写为 null
+        if (!(d == d) || d - d != 0) return null();
+        if (d >= -9.2e18 && d <= 9.2e18 && d == (double)(long long)d) return value((long long)d);
+        prefix();
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), d);
+        m_out.append(buf, res.ptr);
+        return *this;
+    }
+    Writer& value(std::string_view s) { prefix(); escapeStringTo(m_out, s); return *this; }
+    Writer& value(const char* s)      { return value(std::string_view(s)); }
+    Writer& value(const std::string& s) { return value(std::string_view(s)); }
+    Writer& value(const String& s)    { return value(std::string_view(s)); }
+
+    // 写入整棵 Value 树
+    Writer& value(const Value& v) {
+        if (v.is_null())   return null();
+        if (v.is_bool())   return value(v.get_bool());
+        if (v.is_int())    return value((long long)v.get_int64());
+        if (v.is_number()) return value(v.get_number());
+        if (v.is_string()) return value(v.get_string_view());
+        if (v.is_array()) {
+            startArray();
+            for (const auto& e : v.get_array()) value(e);
+            return endArray();
+        }
+        if (v.is_object()) {
+            startObject();
+            for (const auto& [k, e] : v.get_object()) { key(k); value(e); }
+            return endObject();
+        }
+        return null();
+    }
+
+    std::string& out() { return m_out; }
+
+private:
+    std::string&               m_out;
+    bool                       m_pretty;
+    int                        m_step;
+    int                        m_base;
+    bool                       m_afterKey = false;
+    std::vector<unsigned char> m_levels;   // 每层已写入的成员数是否非零
+
+    template <class Int>
+    Writer& integer(Int n) {
+        prefix();
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), n);
+        m_out.append(buf, res.ptr);
+        return *this;
+    }
+
+    void newline(size_t level) {
+        m_out += '\n';
+        m_out.append((size_t)m_base + level * (size_t)m_step, ' ');
+    }
+
+    // 写入键或值之前：补逗号与换行缩进（紧跟在键之后的值除外）
+    void prefix() {
+        if (m_afterKey) { m_afterKey = false; return; }
+        if (m_levels.empty()) return;
+        if (m_levels.back()) m_out += ',';
+        m_levels.back() = 1;
+        if (m_pretty) newline(m_levels.size());
+    }
+
+    void close(char c) {
+        bool hadMembers = m_levels.back() != 0;
+        m_levels.pop_back();
+        if (m_pretty && hadMembers) newline(m_levels.size());
+        m_out += c;
+    }
+};
+
+// 带缩进的格式化输出；indent 为起始缩进（首行不缩进）
 static inline std::string stringify(const Value& v, int indent = 0, int step = 2) {
-    std::ostringstream oss;
-    std::string pad(indent, ' ');
-    std::string inner(indent + step, ' ');
-
-    if (v.is_null())   return "null";
-    if (v.is_bool())   return v.get_bool() ? "true" : "false";
-    if (v.is_number()) {
-        double d = v.get_number();
-        if (d == (long long)d) {
-            oss << (long long)d;
-        } else {
-            oss << std::setprecision(15) << d;
-        }
-        return oss.str();
-    }
-    if (v.is_string()) return escapeString(v.get_string());
-    if (v.is_array()) {
-        const auto& arr = v.get_array();
-        if (arr.empty()) return "[]";
-        oss << "[\n";
-        for (size_t i = 0; i < arr.size(); ++i) {
-            oss << inner << stringify(arr[i], indent + step, step);
-            if (i + 1 < arr.size()) oss << ",";
-            oss << "\n";
-        }
-        oss << pad << "]";
-        return oss.str();
-    }
-    if (v.is_object()) {
-        const auto& obj = v.get_object();
-        if (obj.empty()) return "{}";
-        oss << "{\n";
-        size_t i = 0;
-        for (const auto& [key, val] : obj) {
-            oss << inner << escapeString(key) << ": " << stringify(val, indent + step, step);
-            if (++i < obj.size()) oss << ",";
-            oss << "\n";
-        }
-        oss << pad << "}";
-        return oss.str();
-    }
-    return "null";
+    std::string out;
+    Writer(out, true, step, indent).value(v);
+    return out;
+}
+
+// 紧凑输出（无空白），追加到 out
+static inline void write(std::string& out, const Value& v) {
+    Writer(out).value(v);
 }
 
 // ─── Parser ──────────────────────────────────────────────────────────────────
 struct Parser {
     const char* p;
     const char* end;
+    bool        insitu = false;   // true 时无转义字符串以视图形式引用输入缓冲区
+    std::pmr::memory_resource* mr = std::pmr::get_default_resource();   // 解析结果的分配来源
+    KeyPool*    keys  = nullptr;                                         // 对象键的驻留池，为空时对象自行保存键
+    int         depth = 0;        // 当前容器嵌套深度
 
     void skip() {
         while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
@@ -177,19 +968,29 @@ struct Parser {
         if (c == '"') return parseString();
         if (c == '{') return parseObject();
         if (c == '[') return parseArray();
-        if (c == 't') { p += 4; return Value(true); }
-        if (c == 'f') { p += 5; return Value(false); }
-        if (c == 'n') { p += 4; return Value(nullptr); }
+        if (c == 't') { literal("true");  return Value(true); }
+        if (c == 'f') { literal("false"); return Value(false); }
+        if (c == 'n') { literal("null");  return Value(nullptr); }
         if (c == '-' || (c >= '0' && c <= '9')) return parseNumber();
+        if (p >= end) throw std::runtime_error("Unexpected end of input");
         throw std::runtime_error(std::string("Unexpected char: ") + c);
     }
 
-    std::string parseRawString() {
-        expect('"');
-        std::string s;
+    void literal(std::string_view lit) {
+        if ((size_t)(end - p) < lit.size() || std::string_view(p, lit.size()) != lit)
+            throw std::runtime_error("Invalid literal, expected " + std::string(lit));
+        p += lit.size();
+    }
+
+    void enter() {
+        if (++depth > detail::kMaxDepth) throw std::runtime_error("Nesting too deep");
+    }
+
+    // 解码从 p 开始的转义序列直到结束引号，结果追加到 s
+    void decodeEscaped(String& s) {
         while (p < end && *p != '"') {
             if (*p == '\\') {
-                ++p;
+                if (++p >= end) break;
                 switch (*p++) {
                 case '"':  s += '"';  break;
                 case '\\': s += '\\'; break;
@@ -200,71 +1001,111 @@ struct Parser {
                 case 'b':  s += '\b'; break;
                 case 'f':  s += '\f'; break;
                 case 'u': {
-                    // simple 4-hex BMP decode
-                    char hex[5] = {};
-                    for (int i = 0; i < 4; i++) hex[i] = *p++;
-                    unsigned int cp = (unsigned int)std::stoul(hex, nullptr, 16);
-                    if (cp < 0x80) s += (char)cp;
-                    else if (cp < 0x800) {
-                        s += (char)(0xC0 | (cp >> 6));
-                        s += (char)(0x80 | (cp & 0x3F));
-                    } else {
-                        s += (char)(0xE0 | (cp >> 12));
-                        s += (char)(0x80 | ((cp >> 6) & 0x3F));
-                        s += (char)(0x80 | (cp & 0x3F));
+                    // 4 位十六进制 BMP 码点；不足 4 字节或含非法字符时报错，绝不越过 end
+                    if (end - p < 4) throw std::runtime_error("Invalid \\u escape");
+                    unsigned int cp = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int h = detail::hexDigit(*p++);
+                        if (h < 0) throw std::runtime_error("Invalid \\u escape");
+                        cp = cp * 16 + (unsigned)h;
                     }
+                    detail::appendUtf8(s, cp);
                     break;
                 }
                 default: s += *(p-1); break;
                 }
             } else {
-                s += *p++;
+                // 整段拷贝下一个转义符之前的普通字符
+                const char* run = p;
+                p = detail::scanSpecial<false>(p, end);
+                s.append(run, p);
             }
         }
-        if (*p == '"') ++p;
-        return s;
+        if (p >= end) throw std::runtime_error("Unterminated string");
+        ++p;
     }
 
-    Value parseString() { return Value(parseRawString()); }
+    // 解析字符串：无转义时返回指向输入缓冲区的视图（scratch 不变）；
+    // 含转义时解码到 scratch 并返回其视图。escaped 指示结果位于何处
+    std::string_view parseStringView(String& scratch, bool& escaped) {
+        expect('"');
+        const char* start = p;
+        p = detail::scanSpecial<false>(p, end);
+        if (p < end && *p == '"') {
+            escaped = false;
+            return std::string_view(start, (size_t)(p++ - start));
+        }
+        escaped = true;
+        scratch.assign(start, p);
+        decodeEscaped(scratch);
+        return scratch;
+    }
 
+    Value parseString() {
+        String s(mr);
+        bool escaped = false;
+        std::string_view v = parseStringView(s, escaped);
+        if (escaped) return Value(std::string_view(s), mr);
+        if (insitu) return Value::view(v);
+        return Value(v, mr);
+    }
+
+    // 整数优先按 int64_t 精确解析（溢出时退回 double），直接在输入缓冲区上 from_chars，不分配临时串
     Value parseNumber() {
         const char* start = p;
+        bool isInt = true;
         if (*p == '-') ++p;
         while (p < end && *p >= '0' && *p <= '9') ++p;
-        if (p < end && *p == '.') { ++p; while (p < end && *p >= '0' && *p <= '9') ++p; }
+        if (p < end && *p == '.') { isInt = false; ++p; while (p < end && *p >= '0' && *p <= '9') ++p; }
         if (p < end && (*p == 'e' || *p == 'E')) {
+            isInt = false;
             ++p;
-            if (*p == '+' || *p == '-') ++p;
+            if (p < end && (*p == '+' || *p == '-')) ++p;
             while (p < end && *p >= '0' && *p <= '9') ++p;
         }
-        return Value(std::stod(std::string(start, p)));
+        if (isInt) {
+            int64_t n = 0;
+            auto res = std::from_chars(start, p, n);
+            if (res.ec == std::errc() && res.ptr == p) return Value((long long)n);
+            if (res.ec != std::errc::result_out_of_range) throw std::runtime_error("Invalid number");
+        }
+        double d = 0;
+        auto res = std::from_chars(start, p, d);
+        if (res.ec != std::errc() || res.ptr != p) throw std::runtime_error("Invalid number");
+        return Value(d);
     }
 
     Value parseObject() {
         expect('{');
-        Object obj;
-        if (peek() == '}') { ++p; return Value(std::move(obj)); }
+        enter();
+        Object obj(mr, keys);
+        if (peek() == '}') { ++p; --depth; return Value(std::move(obj)); }
+        String scratch(mr);
         while (true) {
-            std::string key = parseRawString();
+            bool escaped = false;
+            std::string_view key = parseStringView(scratch, escaped);
             expect(':');
             obj[key] = parseValue();
             char c2 = next();
             if (c2 == '}') break;
             if (c2 != ',') throw std::runtime_error("Expected ',' or '}'");
         }
+        --depth;
         return Value(std::move(obj));
     }
 
     Value parseArray() {
         expect('[');
-        Array arr;
-        if (peek() == ']') { ++p; return Value(std::move(arr)); }
+        enter();
+        Array arr(mr);
+        if (peek() == ']') { ++p; --depth; return Value(std::move(arr)); }
         while (true) {
             arr.push_back(parseValue());
             char c2 = next();
             if (c2 == ']') break;
             if (c2 != ',') throw std::runtime_error("Expected ',' or ']'");
         }
+        --depth;
         return Value(std::move(arr));
     }
 };
@@ -274,4 +1115,741 @@ static inline Value parse(const std::string& s) {
     return parser.parseValue();
 }
 
+// 原位解析：不含转义的字符串值以 std::string_view 形式直接引用 s 的内存，
+// 仅含转义的字符串才会分配。s 必须比返回的 Value 活得更久（或先调用 Value::own()）
+static inline Value parse_insitu(std::string_view s) {
+    Parser parser{ s.data(), s.data() + s.size(), true };
+    return parser.parseValue();
+}
+
+// ─── Document ────────────────────────────────────────────────────────────────
+// 持有一块单调增长的 arena：经由它解析或构建的所有 Value、字符串、数组、对象
+// 都从 arena 分配，Document 析构时一次性释放，免去逐节点的 malloc/free；对象键驻留在文档自己的 KeyPool 中。
+// 注意：从 Document 中 move 出去的 Value 仍引用 arena，不得比 Document 活得更久；
+// 需要长期保存时请拷贝（拷贝结果使用默认分配器）
+class Document {
+public:
+    explicit Document(size_t initialBytes = 4096) : m_arena(initialBytes), m_keys(&m_arena) {}
+    Document(const Document&)            = delete;
+    Document& operator=(const Document&) = delete;
+
+    std::pmr::memory_resource* resource() { return &m_arena; }
+    KeyPool*                   keys()     { return &m_keys; }
+
+    Value&       root()       { return m_root; }
+    const Value& root() const { return m_root; }
+
+    // 解析 text 并替换 root；字符串均拷贝进 arena
+    Value& parse(std::string_view text) {
+        Parser parser{ text.data(), text.data() + text.size(), false, &m_arena, &m_keys };
+        m_root = parser.parseValue();
+        return m_root;
+    }
+    // 原位解析：无转义字符串引用 text，text 须比 Document 活得更久
+    Value& parse_insitu(std::string_view text) {
+        Parser parser{ text.data(), text.data() + text.size(), true, &m_arena, &m_keys };
+        m_root = parser.parseValue();
+        return m_root;
+    }
+
+    // 构建辅助：返回从 arena 分配的空容器 / 字符串
+    Object object() { return Object(&m_arena, &m_keys); }
+    Array  array()  { return Array(&m_arena); }
+    Value  str(std::string_view v) { return Value(v, &m_arena); }
+
+private:
+    std::pmr::monotonic_buffer_resource m_arena;   // 须先于 m_keys / m_root 声明，保证最后析构
+    KeyPool                             m_keys;    // 本文档对象键的驻留池
+    Value                               m_root;
+};
+
+// ─── Reader（流式拉取解析）─────────────────────────────────────────────────────
+// 逐个产出词法事件而不构建 DOM；输入可以是内存缓冲区，也可以是 std::istream
+// （按块读取，内存占用与文档大小无关）。用法：
+//     sj::Reader r(stream);
+//     for (sj::Event e = r.next(); e != sj::Event::End; e = r.next()) { ... }
+// Key / String 事件的内容通过 str() 获取，Number / Bool 分别通过 number() / boolean()，
+// str() 返回的视图在下一次调用 next() 之前有效。格式错误时抛出 std::runtime_error
+enum class Event { StartObject, EndObject, StartArray, EndArray, Key, String, Number, Bool, Null, End };
+
+class Reader {
+public:
+    explicit Reader(std::string_view text) : m_p(text.data()), m_end(text.data() + text.size()) {}
+    explicit Reader(std::istream& in, size_t chunkSize = 64 * 1024)
+        : m_in(&in), m_chunk(chunkSize ? chunkSize : 1) {}
+
+    Event next() {
+        switch (m_expect) {
+        case Expect::KeyOrEnd:
+            if (peekc() == '}') return closeContainer('{');
+            return readKey();
+        case Expect::Key:
+            return readKey();
+        case Expect::ValueOrEnd:
+            if (peekc() == ']') return closeContainer('[');
+            return readValue();
+        case Expect::Value:
+            return readValue();
+        case Expect::CommaOrEnd: {
+            int c = peekc();
+            char open = m_stack.back();
+            if (c == ',') {
+                ++m_p;
+                if (open == '{') return readKey();
+                return readValue();
+            }
+            if ((open == '{' && c == '}') || (open == '[' && c == ']')) return closeContainer(open);
+            throw std::runtime_error(open == '{' ? "Expected ',' or '}'" : "Expected ',' or ']'");
+        }
+        case Expect::Done:
+            if (peekc() != -1) throw std::runtime_error("Trailing characters after JSON value");
+            return Event::End;
+        }
+        return Event::End;
+    }
+
+    std::string_view str() const { return m_str; }
+    double number()  const { return m_isInt ? (double)m_int : m_num; }
+    // Number 事件是否为整数字面量；integer() 对浮点数取截断值，超出 int64 范围时取最近的端点
+    bool    is_integer() const { return m_isInt; }
+    int64_t integer()    const { return m_isInt ? m_int : detail::saturateInt64(m_num); }
+    bool   boolean() const { return m_bool; }
+    size_t depth()   const { return m_stack.size(); }
+
+    // 跳过以事件 e 开头的值：若 e 为 StartObject / StartArray，消费到与之匹配的结束事件
+    void skip(Event e) {
+        if (e != Event::StartObject && e != Event::StartArray) return;
+        size_t target = m_stack.size() - 1;
+        while (m_stack.size() > target) next();
+    }
+    // 跳过下一个完整的值（通常在 Key 事件之后调用）
+    void skipValue() { skip(next()); }
+
+private:
+    enum class Expect { Value, KeyOrEnd, Key, ValueOrEnd, CommaOrEnd, Done };
+
+    const char*   m_p   = nullptr;
+    const char*   m_end = nullptr;
+    std::istream* m_in  = nullptr;
+    size_t        m_chunk = 0;
+    std::string   m_buf;               // 流模式下的读缓冲
+    std::string   m_scratch;           // 含转义或跨块的字符串解码结果
+    std::string   m_stack;             // 尚未闭合的 '{' / '['
+    Expect        m_expect = Expect::Value;
+    std::string_view m_str;
+    double        m_num  = 0;
+    int64_t       m_int  = 0;
+    bool          m_isInt = false;
+    bool          m_bool = false;
+
+    // 流模式：丢弃已消费部分并追加下一块，无更多数据时返回 false
+    bool fill() {
+        if (!m_in || !*m_in) return false;
+        size_t keep = (size_t)(m_end - m_p);
+        m_buf.erase(0, m_buf.size() - keep);
+        size_t old = m_buf.size();
+        m_buf.resize(old + m_chunk);
+        m_in->read(&m_buf[old], (std::streamsize)m_chunk);
+        m_buf.resize(old + (size_t)m_in->gcount());
+        m_p   = m_buf.data();
+        m_end = m_buf.data() + m_buf.size();
+        return m_buf.size() > keep;
+    }
+
+    int rawc() {
+        if (m_p == m_end && !fill()) return -1;
+        return (unsigned char)*m_p;
+    }
+    // 跳过空白后返回下一个字符（不消费），输入结束返回 -1
+    int peekc() {
+        for (;;) {
+            int c = rawc();
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return c;
+            ++m_p;
+        }
+    }
+
+    void afterValue() { m_expect = m_stack.empty() ? Expect::Done : Expect::CommaOrEnd; }
+
+    Event closeContainer(char open) {
+        ++m_p;
+        m_stack.pop_back();
+        afterValue();
+        return open == '{' ? Event::EndObject : Event::EndArray;
+    }
+
+    Event readKey() {
+        if (peekc() != '"') throw std::runtime_error("Expected object key");
+        readString();
+        // 流模式下查找 ':' 可能触发补充缓冲区，先把指向缓冲区的键拷出
+        if (m_in && m_str.data() != m_scratch.data()) { m_scratch.assign(m_str); m_str = m_scratch; }
+        if (peekc() != ':') throw std::runtime_error("Expected ':'");
+        ++m_p;
+        m_expect = Expect::Value;
+        return Event::Key;
+    }
+
+    Event readValue() {
+        int c = peekc();
+        switch (c) {
+        case '{': ++m_p; m_stack += '{'; m_expect = Expect::KeyOrEnd;   return Event::StartObject;
+        case '[': ++m_p; m_stack += '['; m_expect = Expect::ValueOrEnd; return Event::StartArray;
+        case '"': readString(); afterValue(); return Event::String;
+        case 't': readLiteral("true");  m_bool = true;  afterValue(); return Event::Bool;
+        case 'f': readLiteral("false"); m_bool = false; afterValue(); return Event::Bool;
+        case 'n': readLiteral("null");  afterValue(); return Event::Null;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) { readNumber(); afterValue(); return Event::Number; }
+            if (c == -1) throw std::runtime_error("Unexpected end of input");
+            throw std::runtime_error(std::string("Unexpected char: ") + (char)c);
+        }
+    }
+
+    void readLiteral(const char* lit) {
+        for (const char* q = lit; *q; ++q, ++m_p)
+            if (rawc() != *q) throw std::runtime_error(std::string("Invalid literal, expected ") + lit);
+    }
+
+    // 与 Parser::parseNumber 相同，直接在缓冲区上 from_chars，长度不受限制。
+    // 扫描期间不移动 m_p：流模式补充缓冲区时 [m_p, m_end) 会被保留，数字始终连续
+    void readNumber() {
+        size_t n = 0;
+        bool isInt = true;
+        for (;;) {
+            if (m_p + n == m_end && !fill()) break;
+            char c = m_p[n];
+            if (c == '.' || c == 'e' || c == 'E') isInt = false;
+            else if (!((c >= '0' && c <= '9') || c == '-' || c == '+')) break;
+            ++n;
+        }
+        const char* start = m_p;
+        m_p += n;
+        m_isInt = false;
+        if (isInt) {
+            auto ri = std::from_chars(start, m_p, m_int);
+            if (ri.ec == std::errc() && ri.ptr == m_p) { m_isInt = true; return; }
+        }
+        auto res = std::from_chars(start, m_p, m_num);
+        if (res.ec != std::errc() || res.ptr != m_p) throw std::runtime_error("Invalid number");
+    }
+
+    // 读取字符串（当前位于开引号）。整段落在缓冲区内且无转义时直接返回缓冲区视图
+    void readString() {
+        ++m_p;
+        const char* start = m_p;
+        const char* hit = detail::scanSpecial<false>(m_p, m_end);
+        if (hit < m_end && *hit == '"') {
+            m_str = std::string_view(start, (size_t)(hit - start));
+            m_p = hit + 1;
+            return;
+        }
+        m_scratch.clear();
+        for (;;) {
+            hit = detail::scanSpecial<false>(m_p, m_end);
+            m_scratch.append(m_p, hit);
+            m_p = hit;
+            int c = rawc();
+            if (c == -1) throw std::runtime_error("Unterminated string");
+            if (c == '"') { ++m_p; break; }
+            if (c != '\\') continue;          // 缓冲区耗尽后已补充，继续扫描
+            ++m_p;
+            int e = rawc();
+            if (e == -1) throw std::runtime_error("Unterminated string");
+            ++m_p;
+            switch (e) {
+            case 'n': m_scratch += '\n'; break;
+            case 'r': m_scratch += '\r'; break;
+            case 't': m_scratch += '\t'; break;
+            case 'b': m_scratch += '\b'; break;
+            case 'f': m_scratch += '\f'; break;
+            case 'u': {
+                unsigned int cp = 0;
+                for (int i = 0; i < 4; ++i) {
+                    int c = rawc();
+                    int h = c == -1 ? -1 : detail::hexDigit((char)c);
+                    if (h < 0) throw std::runtime_error("Invalid \\u escape");
+                    cp = cp * 16 + (unsigned)h;
+                    ++m_p;
+                }
+                detail::appendUtf8(m_scratch, cp);
+                break;
+            }
+            default: m_scratch += (char)e; break;   // '"'、'\\'、'/' 及其余字符原样保留
+            }
+        }
+        m_str = m_scratch;
+    }
+};
+
+// ─── Lazy（按需访问）──────────────────────────────────────────────────────────
+// 构造时对整段文本做一次结构校验（括号、逗号、冒号、字符串边界、字面量），但不解码字符串、
+// 不转换数字、不分配内存；之后按键 / 下标定位子值，子值以原始文本切片 raw() 的形式返回，
+// 可直接交给 sj::decode 或 sj::Reader，只有真正访问到的值才会被解码。用法：
+//     sj::Lazy msg = sj::Lazy::parse(text);
+//     std::string action = msg["action"].get_string_or("");
+//     sj::decode(msg["process"].raw_or("{}"), cfg);
+// Lazy 只引用 text，不持有内存，使用期间 text 须保持有效
+namespace detail {
+
+inline const char* lazyWs(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+// p 指向开引号，返回闭引号之后的位置
+inline const char* lazyString(const char* p, const char* end, bool validate) {
+    for (++p;;) {
+        p = scanSpecial<false>(p, end);
+        if (p >= end) throw std::runtime_error("Unterminated string");
+        if (*p++ == '"') return p;
+        if (p >= end) throw std::runtime_error("Unterminated string");
+        if (*p++ != 'u' || !validate) continue;
+        if (end - p < 4) throw std::runtime_error("Invalid \\u escape");
+        for (int i = 0; i < 4; ++i, ++p)
+            if (hexDigit(*p) < 0) throw std::runtime_error("Invalid \\u escape");
+    }
+}
+
+inline const char* lazyLiteral(const char* p, const char* end, std::string_view lit) {
+    if ((size_t)(end - p) < lit.size() || std::string_view(p, lit.size()) != lit)
+        throw std::runtime_error(std::string("Invalid literal, expected ") + std::string(lit));
+    return p + lit.size();
+}
+
+// 跳过 p 处的一个值，返回其后的位置；validate 为 false 时假定文本已校验过
+inline const char* lazyValue(const char* p, const char* end, bool validate, int depth = 0) {
+    if (p >= end) throw std::runtime_error("Unexpected end of input");
+    char c = *p;
+    if (c == '"') return lazyString(p, end, validate);
+    if (c == '{' || c == '[') {
+        if (depth >= kMaxDepth) throw std::runtime_error("Nesting too deep");
+        const char close = c == '{' ? '}' : ']';
+        p = lazyWs(p + 1, end);
+        if (p < end && *p == close) return p + 1;
+        for (;;) {
+            if (c == '{') {
+                if (p >= end || *p != '"') throw std::runtime_error("Expected object key");
+                p = lazyWs(lazyString(p, end, validate), end);
+                if (p >= end || *p != ':') throw std::runtime_error("Expected ':'");
+                p = lazyWs(p + 1, end);
+            }
+            p = lazyWs(lazyValue(p, end, validate, depth + 1), end);
+            if (p < end && *p == ',') { p = lazyWs(p + 1, end); continue; }
+            if (p < end && *p == close) return p + 1;
+            throw std::runtime_error(c == '{' ? "Expected ',' or '}'" : "Expected ',' or ']'");
+        }
+    }
+    if (c == 't') return lazyLiteral(p, end, "true");
+    if (c == 'f') return lazyLiteral(p, end, "false");
+    if (c == 'n') return lazyLiteral(p, end, "null");
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        // 只确定边界；数值本身在被访问时由 Reader 转换
+        do ++p; while (p < end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' ||
+                                   *p == 'E' || *p == '+' || *p == '-'));
+        return p;
+    }
+    throw std::runtime_error(std::string("Unexpected char: ") + c);
+}
+
+} // namespace detail
+
+class Lazy {
+public:
+    Lazy() = default;   // 不存在的值
+
+    // 校验 text 为单个完整的 JSON 值，格式错误时抛出 std::runtime_error
+    static Lazy parse(std::string_view text) {
+        const char* end = text.data() + text.size();
+        const char* p = detail::lazyWs(text.data(), end);
+        const char* q = detail::lazyValue(p, end, true);
+        if (detail::lazyWs(q, end) != end) throw std::runtime_error("Trailing characters after JSON value");
+        return Lazy(std::string_view(p, (size_t)(q - p)));
+    }
+
+    bool exists()    const { return !m_raw.empty(); }
+    bool is_null()   const { return first() == 'n'; }
+    bool is_bool()   const { return first() == 't' || first() == 'f'; }
+    bool is_number() const { return first() == '-' || (first() >= '0' && first() <= '9'); }
+    bool is_string() const { return first() == '"'; }
+    bool is_object() const { return first() == '{'; }
+    bool is_array()  const { return first() == '['; }
+
+    // 值的原始 JSON 文本（不含前后空白）
+    std::string_view raw() const { return m_raw; }
+    std::string_view raw_or(std::string_view def) const { return exists() ? m_raw : def; }
+
+    // 对象成员；非对象或键不存在时返回不存在的值。同名键取第一个
+    Lazy operator[](std::string_view key) const {
+        if (!is_object()) return {};
+        std::string_view found;
+        forEachMember([&](std::string_view rawKey, std::string_view val) {
+            if (!keyEquals(rawKey, key)) return true;
+            found = val;
+            return false;
+        });
+        return Lazy(found);
+    }
+
+    // 数组元素；越界或非数组时返回不存在的值
+    Lazy operator[](size_t index) const {
+        if (!is_array()) return {};
+        const char* end = m_raw.data() + m_raw.size();
+        const char* p = detail::lazyWs(m_raw.data() + 1, end);
+        if (*p == ']') return {};
+        for (size_t i = 0;; ++i) {
+            const char* q = detail::lazyValue(p, end, false);
+            if (i == index) return Lazy(std::string_view(p, (size_t)(q - p)));
+            p = detail::lazyWs(q, end);
+            if (*p != ',') return {};
+            p = detail::lazyWs(p + 1, end);
+        }
+    }
+
+    bool contains(std::string_view key) const { return (*this)[key].exists(); }
+
+    // 类型不符或不存在时返回 def
+    std::string get_string_or(std::string_view def) const {
+        if (!is_string()) return std::string(def);
+        try {
+            Reader r(m_raw);
+            r.next();
+            return std::string(r.str());
+        } catch (...) { return std::string(def); }
+    }
+    bool get_bool_or(bool def) const {
+        return is_bool() ? first() == 't' : def;
+    }
+    // 浮点数取截断值，超出目标类型的范围时返回 def
+    int64_t get_int64_or(int64_t def) const { return intOr(def); }
+    int     get_int_or(int def)       const { return intOr(def); }
+
+private:
+    explicit Lazy(std::string_view raw) : m_raw(raw) {}
+    char first() const { return m_raw.empty() ? '\0' : m_raw.front(); }
+
+    template <class T>
+    T intOr(T def) const {
+        if (!is_number()) return def;
+        try {
+            Reader r(m_raw);
+            r.next();
+            T v;
+            return detail::readInteger(r, v) ? v : def;
+        } catch (...) { return def; }
+    }
+
+    // fn(带引号的原始键, 值文本) 返回 false 时停止遍历
+    template <class F>
+    void forEachMember(F&& fn) const {
+        const char* end = m_raw.data() + m_raw.size();
+        const char* p = detail::lazyWs(m_raw.data() + 1, end);
+        if (*p == '}') return;
+        for (;;) {
+            const char* k = p;
+            p = detail::lazyString(p, end, false);
+            std::string_view rawKey(k, (size_t)(p - k));
+            p = detail::lazyWs(detail::lazyWs(p, end) + 1, end);   // 跳过 ':'
+            const char* q = detail::lazyValue(p, end, false);
+            if (!fn(rawKey, std::string_view(p, (size_t)(q - p)))) return;
+            p = detail::lazyWs(q, end);
+            if (*p != ',') return;
+            p = detail::lazyWs(p + 1, end);
+        }
+    }
+
+    static bool keyEquals(std::string_view rawKey, std::string_view key) {
+        std::string_view inner = rawKey.substr(1, rawKey.size() - 2);
+        if (inner.find('\\') == std::string_view::npos) return inner == key;
+        Reader r(rawKey);   // 含转义的键才解码后比较
+        r.next();
+        return r.str() == key;
+    }
+
+    std::string_view m_raw;
+};
+
+// ─── 结构体绑定 ──────────────────────────────────────────────────────────────
+// 在结构体所在命名空间内用 SJ_FIELDS 声明需要序列化的成员，即可不经 DOM
+// 直接在 JSON 与结构体之间编解码：
+//     struct Foo { std::string id; int n = 0; std::vector<std::string> tags; };
+//     SJ_FIELDS(Foo, id, n, tags)
+//     sj::encode(writer, foo);                 // 写出 {"id":...,"n":...,"tags":[...]}
+//     sj::FieldMask m = sj::decode(text, foo); // 只覆盖 JSON 中出现且类型匹配的成员
+// 支持的成员类型：bool、整数、浮点、std::string、std::vector<E>、以及声明了 SJ_FIELDS 的结构体。
+// 解码时类型不匹配的成员保持原值，未知的键被跳过；返回值的第 i 位表示第 i 个成员已被赋值。
+// 超出成员类型取值范围的数值（如 int 成员遇到 1e10、unsigned 成员遇到负数）同样按类型不匹配处理
+// 若结构体所在命名空间提供 void sj_decoded(T&, sj::FieldMask)，每个对象解码完成后会调用它补全默认值
+using FieldMask = uint64_t;
+
+template <class T, class M>
+struct Field {
+    std::string_view name;
+    M T::*           member;
+};
+
+template <class T, class M>
+constexpr Field<T, M> field(std::string_view name, M T::* member) { return { name, member }; }
+
+namespace detail {
+
+template <class T, class = void>
+struct HasFields : std::false_type {};
+template <class T>
+struct HasFields<T, std::void_t<decltype(sj_fields((const T*)nullptr))>> : std::true_type {};
+
+template <class T, class = void>
+struct HasDecodedHook : std::false_type {};
+template <class T>
+struct HasDecodedHook<T, std::void_t<decltype(sj_decoded(std::declval<T&>(), FieldMask{}))>> : std::true_type {};
+
+template <class T>          struct IsVector : std::false_type {};
+template <class E, class A> struct IsVector<std::vector<E, A>> : std::true_type {};
+
+template <class T>
+constexpr auto fieldsOf() { return sj_fields((const T*)nullptr); }
+
+template <class T>
+constexpr size_t fieldCount() { return std::tuple_size<decltype(fieldsOf<T>())>::value; }
+
+// 成员名登记到全局键表，独立对象中的这些键不再各自分配
+template <class T>
+bool registerKeys() {
+    std::apply([](const auto&... f) { (GlobalKeys::instance().add(f.name), ...); }, fieldsOf<T>());
+    return true;
+}
+
+} // namespace detail
+
+template <class T> void encode(Writer& w, const T& v);
+template <class R, class T> bool decodeValue(R& r, Event e, T& out);
+
+// 仅写出成员的键值对（不含花括号），便于在同一对象中追加额外字段
+template <class T>
+void encodeFields(Writer& w, const T& v) {
+    std::apply([&](const auto&... f) { ((w.key(f.name), encode(w, v.*(f.member))), ...); },
+               detail::fieldsOf<T>());
+}
+
+template <class T>
+void encode(Writer& w, const T& v) {
+    if constexpr (detail::HasFields<T>::value) {
+        w.startObject();
+        encodeFields(w, v);
+        w.endObject();
+    } else if constexpr (detail::IsVector<T>::value) {
+        w.startArray();
+        for (const auto& e : v) encode(w, e);
+        w.endArray();
+    } else {
+        w.value(v);
+    }
+}
+
+template <class T>
+std::string encode(const T& v, bool pretty = false) {
+    std::string out;
+    Writer w(out, pretty);
+    encode(w, v);
+    return out;
+}
+
+namespace detail {
+
+template <class R, class T, class Tuple, size_t... I>
+bool decodeField(R& r, T& out, std::string_view key, const Tuple& fs,
+                 FieldMask& mask, std::index_sequence<I...>) {
+    bool found = false;
+    // key 引用 Reader 内部缓冲，只在消费下一个值之前比较
+    ((found || std::get<I>(fs).name != key ? void() :
+        (found = true, decodeValue(r, r.next(), out.*(std::get<I>(fs).member))
+            ? void(mask |= (FieldMask)1 << I) : void())), ...);
+    return found;
+}
+
+template <class T, class Tuple, size_t... I>
+void assignFields(T& dst, const T& src, FieldMask mask, const Tuple& fs, std::index_sequence<I...>) {
+    ((mask & ((FieldMask)1 << I) ? void(dst.*(std::get<I>(fs).member) = src.*(std::get<I>(fs).member)) : void()), ...);
+}
+
+template <class T, class Tuple, size_t... I>
+FieldMask diffFields(const T& a, const T& b, const Tuple& fs, std::index_sequence<I...>) {
+    FieldMask m = 0;
+    ((m |= a.*(std::get<I>(fs).member) == b.*(std::get<I>(fs).member) ? 0 : (FieldMask)1 << I), ...);
+    return m;
+}
+
+// 当前位于 StartObject 之后，解码到 EndObject。R 为 Reader 或产出相同事件序列的
+// 拉取解析器（如 sj::msgpack::Unpacker）
+template <class R, class T>
+FieldMask decodeObject(R& r, T& out) {
+    static_assert(fieldCount<T>() <= 64, "SJ_FIELDS supports at most 64 members");
+    constexpr auto fs = fieldsOf<T>();
+    FieldMask mask = 0;
+    for (Event e = r.next(); e == Event::Key; e = r.next()) {
+        if (!decodeField(r, out, r.str(), fs, mask, std::make_index_sequence<fieldCount<T>()>{}))
+            r.skipValue();
+    }
+    if constexpr (HasDecodedHook<T>::value) sj_decoded(out, mask);
+    return mask;
+}
+
+} // namespace detail
+
+// 以事件 e 开头的值解码到 out；类型不符时跳过该值、out 保持不变并返回 false
+template <class R, class T>
+bool decodeValue(R& r, Event e, T& out) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (e == Event::Bool) { out = r.boolean(); return true; }
+    } else if constexpr (std::is_integral_v<T>) {
+        if (e == Event::Number && detail::readInteger(r, out)) return true;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        // double 转 float 越界同样是未定义行为
+        if (e == Event::Number) {
+            double d = r.number();
+            if (!std::isfinite(d) || std::fabs(d) <= (double)std::numeric_limits<T>::max()) { out = (T)d; return true; }
+        }
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        if (e == Event::String) { out.assign(r.str()); return true; }
+    } else if constexpr (detail::IsVector<T>::value) {
+        if (e == Event::StartArray) {
+            out.clear();
+            for (Event ee = r.next(); ee != Event::EndArray; ee = r.next()) {
+                typename T::value_type item{};
+                if (decodeValue(r, ee, item)) out.push_back(std::move(item));
+            }
+            return true;
+        }
+    } else {
+        static_assert(detail::HasFields<T>::value, "type has no SJ_FIELDS declaration");
+        if (e == Event::StartObject) { detail::decodeObject(r, out); return true; }
+    }
+    r.skip(e);
+    return false;
+}
+
+// 从 Reader 读取下一个 JSON 值到 out，返回被赋值的成员掩码；该值不是对象时跳过并返回 0
+template <class T>
+FieldMask decode(Reader& r, T& out) {
+    Event e = r.next();
+    if (e != Event::StartObject) { r.skip(e); return 0; }
+    return detail::decodeObject(r, out);
+}
+
+template <class T>
+FieldMask decode(std::string_view text, T& out) {
+    Reader r(text);
+    FieldMask mask = decode(r, out);
+    if (r.next() != Event::End) throw std::runtime_error("Trailing characters after JSON value");
+    return mask;
+}
+
+// 名为 name 的成员对应的掩码位，不存在时为 0
+template <class T>
+constexpr FieldMask fieldMask(std::string_view name) {
+    FieldMask m = 0, bit = 1;
+    std::apply([&](const auto&... f) { ((m |= (f.name == name ? bit : 0), bit <<= 1), ...); },
+               detail::fieldsOf<T>());
+    return m;
+}
+
+// 仅拷贝 mask 中标记的成员
+template <class T>
+void assignFields(T& dst, const T& src, FieldMask mask) {
+    constexpr auto fs = detail::fieldsOf<T>();
+    detail::assignFields(dst, src, mask, fs, std::make_index_sequence<detail::fieldCount<T>()>{});
+}
+
+// 取值不同的成员掩码；各成员须支持 ==
+template <class T>
+FieldMask diffFields(const T& a, const T& b) {
+    constexpr auto fs = detail::fieldsOf<T>();
+    return detail::diffFields(a, b, fs, std::make_index_sequence<detail::fieldCount<T>()>{});
+}
+
 } // namespace sj
+
+// SJ_FIELDS(Type, member1, member2, ...)：最多 64 个成员（与 FieldMask 的位数一致），须在 Type 所在命名空间内使用。
+// 成员名在静态初始化时登记到 sj::GlobalKeys
+#define SJ_FIELDS(T, ...) \
+    constexpr auto sj_fields(const T*) { return std::make_tuple(SJ_FOR_EACH_(SJ_FIELD_, T, __VA_ARGS__)); } \
+    inline const bool sj_keys_registered_##T = ::sj::detail::registerKeys<T>();
+
+#define SJ_FIELD_(T, f) ::sj::field(#f, &T::f)
+#define SJ_EXPAND_(x) x
+#define SJ_FE_1(M, T, a)       M(T, a)
+#define SJ_FE_2(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_1(M, T, __VA_ARGS__))
+#define SJ_FE_3(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_2(M, T, __VA_ARGS__))
+#define SJ_FE_4(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_3(M, T, __VA_ARGS__))
+#define SJ_FE_5(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_4(M, T, __VA_ARGS__))
+#define SJ_FE_6(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_5(M, T, __VA_ARGS__))
+#define SJ_FE_7(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_6(M, T, __VA_ARGS__))
+#define SJ_FE_8(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_7(M, T, __VA_ARGS__))
+#define SJ_FE_9(M, T, a, ...)  M(T, a), SJ_EXPAND_(SJ_FE_8(M, T, __VA_ARGS__))
+#define SJ_FE_10(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_9(M, T, __VA_ARGS__))
+#define SJ_FE_11(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_10(M, T, __VA_ARGS__))
+#define SJ_FE_12(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_11(M, T, __VA_ARGS__))
+#define SJ_FE_13(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_12(M, T, __VA_ARGS__))
+#define SJ_FE_14(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_13(M, T, __VA_ARGS__))
+#define SJ_FE_15(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_14(M, T, __VA_ARGS__))
+#define SJ_FE_16(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_15(M, T, __VA_ARGS__))
+#define SJ_FE_17(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_16(M, T, __VA_ARGS__))
+#define SJ_FE_18(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_17(M, T, __VA_ARGS__))
+#define SJ_FE_19(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_18(M, T, __VA_ARGS__))
+#define SJ_FE_20(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_19(M, T, __VA_ARGS__))
+#define SJ_FE_21(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_20(M, T, __VA_ARGS__))
+#define SJ_FE_22(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_21(M, T, __VA_ARGS__))
+#define SJ_FE_23(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_22(M, T, __VA_ARGS__))
+#define SJ_FE_24(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_23(M, T, __VA_ARGS__))
+#define SJ_FE_25(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_24(M, T, __VA_ARGS__))
+#define SJ_FE_26(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_25(M, T, __VA_ARGS__))
+#define SJ_FE_27(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_26(M, T, __VA_ARGS__))
+#define SJ_FE_28(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_27(M, T, __VA_ARGS__))
+#define SJ_FE_29(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_28(M, T, __VA_ARGS__))
+#define SJ_FE_30(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_29(M, T, __VA_ARGS__))
+#define SJ_FE_31(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_30(M, T, __VA_ARGS__))
+#define SJ_FE_32(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_31(M, T, __VA_ARGS__))
+#define SJ_FE_33(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_32(M, T, __VA_ARGS__))
+#define SJ_FE_34(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_33(M, T, __VA_ARGS__))
+#define SJ_FE_35(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_34(M, T, __VA_ARGS__))
+#define SJ_FE_36(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_35(M, T, __VA_ARGS__))
+#define SJ_FE_37(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_36(M, T, __VA_ARGS__))
+#define SJ_FE_38(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_37(M, T, __VA_ARGS__))
+#define SJ_FE_39(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_38(M, T, __VA_ARGS__))
+#define SJ_FE_40(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_39(M, T, __VA_ARGS__))
+#define SJ_FE_41(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_40(M, T, __VA_ARGS__))
+#define SJ_FE_42(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_41(M, T, __VA_ARGS__))
+#define SJ_FE_43(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_42(M, T, __VA_ARGS__))
+#define SJ_FE_44(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_43(M, T, __VA_ARGS__))
+#define SJ_FE_45(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_44(M, T, __VA_ARGS__))
+#define SJ_FE_46(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_45(M, T, __VA_ARGS__))
+#define SJ_FE_47(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_46(M, T, __VA_ARGS__))
+#define SJ_FE_48(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_47(M, T, __VA_ARGS__))
+#define SJ_FE_49(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_48(M, T, __VA_ARGS__))
+#define SJ_FE_50(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_49(M, T, __VA_ARGS__))
+#define SJ_FE_51(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_50(M, T, __VA_ARGS__))
+#define SJ_FE_52(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_51(M, T, __VA_ARGS__))
+#define SJ_FE_53(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_52(M, T, __VA_ARGS__))
+#define SJ_FE_54(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_53(M, T, __VA_ARGS__))
+#define SJ_FE_55(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_54(M, T, __VA_ARGS__))
+#define SJ_FE_56(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_55(M, T, __VA_ARGS__))
+#define SJ_FE_57(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_56(M, T, __VA_ARGS__))
+#define SJ_FE_58(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_57(M, T, __VA_ARGS__))
+#define SJ_FE_59(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_58(M, T, __VA_ARGS__))
+#define SJ_FE_60(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_59(M, T, __VA_ARGS__))
+#define SJ_FE_61(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_60(M, T, __VA_ARGS__))
+#define SJ_FE_62(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_61(M, T, __VA_ARGS__))
+#define SJ_FE_63(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_62(M, T, __VA_ARGS__))
+#define SJ_FE_64(M, T, a, ...) M(T, a), SJ_EXPAND_(SJ_FE_63(M, T, __VA_ARGS__))
+#define SJ_FE_PICK_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+                    _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, \
+                    _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, \
+                    _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, NAME, ...) NAME
+#define SJ_FOR_EACH_(M, T, ...) SJ_EXPAND_(SJ_FE_PICK_(__VA_ARGS__, \
+    SJ_FE_64, SJ_FE_63, SJ_FE_62, SJ_FE_61, SJ_FE_60, SJ_FE_59, SJ_FE_58, SJ_FE_57, \
+    SJ_FE_56, SJ_FE_55, SJ_FE_54, SJ_FE_53, SJ_FE_52, SJ_FE_51, SJ_FE_50, SJ_FE_49, \
+    SJ_FE_48, SJ_FE_47, SJ_FE_46, SJ_FE_45, SJ_FE_44, SJ_FE_43, SJ_FE_42, SJ_FE_41, \
+    SJ_FE_40, SJ_FE_39, SJ_FE_38, SJ_FE_37, SJ_FE_36, SJ_FE_35, SJ_FE_34, SJ_FE_33, \
+    SJ_FE_32, SJ_FE_31, SJ_FE_30, SJ_FE_29, SJ_FE_28, SJ_FE_27, SJ_FE_26, SJ_FE_25, \
+    SJ_FE_24, SJ_FE_23, SJ_FE_22, SJ_FE_21, SJ_FE_20, SJ_FE_19, SJ_FE_18, SJ_FE_17, \
+    SJ_FE_16, SJ_FE_15, SJ_FE_14, SJ_FE_13, SJ_FE_12, SJ_FE_11, SJ_FE_10, SJ_FE_9, \
+    SJ_FE_8, SJ_FE_7, SJ_FE_6, SJ_FE_5, SJ_FE_4, SJ_FE_3, SJ_FE_2, SJ_FE_1)(M, T, __VA_ARGS__))
@@ -0,0 +1,440 @@
+// SimpleMsgPack.hpp - MessagePack binary encoding for SimpleJson
+// 与文本 JSON 对称的二进制编码，用于配置缓存、运行时状态持久化和非浏览器 IPC：
+//   sj::msgpack::Packer   —— 接口与 sj::Writer 一致的缓冲区写入器
+//   sj::msgpack::Unpacker —— 产出与 sj::Reader 相同 sj::Event 序列的拉取解析器
+//   sj::msgpack::encode / decode —— sj::Value 树或声明了 SJ_FIELDS 的结构体与 MessagePack 字节之间的互转
+//   sj::msgpack::encodeTuple / decodeTuple —— 结构体按字段表顺序编码为数组，省去成员名，仅供字段表一致的双方使用
+// 数值按最短的整数 / float64 编码，读出时无需文本到数值的转换
+#pragma once
+#include "SimpleJson.hpp"
+
+namespace sj {
+namespace msgpack {
+
+// ─── Packer ──────────────────────────────────────────────────────────────────
+// 用法与 sj::Writer 相同：startObject / key / value / endObject ...
+// 不知道成员数时容器头使用 map32 / array32 并在结束时回填计数；
+// 已知成员数时调用 startObject(n) / startArray(n) 写出最短的头部
+class Packer {
+public:
+    explicit Packer(std::string& out) : m_out(out) {}
+
+    Packer& startObject()         { return open(0xdf); }
+    Packer& startArray()          { return open(0xdd); }
+    Packer& startObject(size_t n) { item(); header(n, 0x80, 0xde, 0xdf); m_levels.push_back({ npos, 0 }); return *this; }
+    Packer& startArray(size_t n)  { item(); header(n, 0x90, 0xdc, 0xdd); m_levels.push_back({ npos, 0 }); return *this; }
+    Packer& endObject()           { return close(); }
+    Packer& endArray()            { return close(); }
+
+    // 键不计入成员数：map 的计数在写键时递增，值不再重复计数
+    Packer& key(std::string_view k) { item(); str(k); m_afterKey = true; return *this; }
+
+    Packer& null()                      { item(); m_out += (char)0xc0; return *this; }
+    Packer& value(std::nullptr_t)       { return null(); }
+    Packer& value(bool b)               { item(); m_out += (char)(b ? 0xc3 : 0xc2); return *this; }
+    Packer& value(int n)                { return value((long long)n); }
+    Packer& value(unsigned n)           { return value((unsigned long long)n); }
+    Packer& value(long n)               { return value((long long)n); }
+    Packer& value(unsigned long n)      { return value((unsigned long long)n); }
+    Packer& value(unsigned long long n) {
+        if (n <= (unsigned long long)INT64_MAX) return value((long long)n);
+        item();
+        m_out += (char)0xcf;
+        be(n, 8);
+        return *this;
+    }
+    Packer& value(long long n) {
+        item();
+        if (n >= 0) {
+            if (n < 0x80)             m_out += (char)n;                   // positive fixint
+            else if (n <= 0xff)       { m_out += (char)0xcc; be((uint64_t)n, 1); }
+            else if (n <= 0xffff)     { m_out += (char)0xcd; be((uint64_t)n, 2); }
+            else if (n <= 0xffffffff) { m_out += (char)0xce; be((uint64_t)n, 4); }
+            else                      { m_out += (char)0xcf; be((uint64_t)n, 8); }
+        } else {
+            if (n >= -32)             m_out += (char)n;                   // negative fixint
+            else if (n >= INT8_MIN)   { m_out += (char)0xd0; be((uint64_t)n, 1); }
+            else if (n >= INT16_MIN)  { m_out += (char)0xd1; be((uint64_t)n, 2); }
+            else if (n >= INT32_MIN)  { m_out += (char)0xd2; be((uint64_t)n, 4); }
+            else                      { m_out += (char)0xd3; be((uint64_t)n, 8); }
+        }
+        return *this;
+    }
+    // 与 Writer 一致：整数值的浮点数按整数编码，NaN / Inf 写为 nil
+    Packer& value(double d) {
+        if (!(d == d) || d - d != 0) return null();
+        if (d >= -9.2e18 && d <= 9.2e18 && d == (double)(long long)d) return value((long long)d);
+        item();
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        m_out += (char)0xcb;
+        be(bits, 8);
+        return *this;
+    }
+    Packer& value(std::string_view s)   { item(); str(s); return *this; }
+    Packer& value(const char* s)        { return value(std::string_view(s)); }
+    Packer& value(const std::string& s) { return value(std::string_view(s)); }
+    Packer& value(const String& s)      { return value(std::string_view(s)); }
+
+    // 写入整棵 Value 树；容器成员数已知，使用最短的头部
+    Packer& value(const Value& v) {
+        if (v.is_null())   return null();
+        if (v.is_bool())   return value(v.get_bool());
+        if (v.is_int())    return value((long long)v.get_int64());
+        if (v.is_number()) return value(v.get_number());
+        if (v.is_string()) return value(v.get_string_view());
+        if (v.is_array()) {
+            startArray(v.get_array().size());
+            for (const auto& e : v.get_array()) value(e);
+            return endArray();
+        }
+        if (v.is_object()) {
+            startObject(v.get_object().size());
+            for (const auto& [k, e] : v.get_object()) { key(k); value(e); }
+            return endObject();
+        }
+        return null();
+    }
+
+    std::string& out() { return m_out; }
+
+private:
+    static constexpr size_t npos = (size_t)-1;
+
+    struct Level {
+        size_t   countPos;   // 待回填的 32 位计数位置；npos 表示头部已写出确定计数
+        uint32_t count;
+    };
+
+    std::string&       m_out;
+    std::vector<Level> m_levels;
+    bool               m_afterKey = false;
+
+    void be(uint64_t v, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) m_out += (char)(unsigned char)(v >> (i * 8));
+    }
+
+    // 每写一个成员（数组元素或对象的键）递增所在容器的计数
+    void item() {
+        if (m_afterKey) { m_afterKey = false; return; }
+        if (!m_levels.empty()) ++m_levels.back().count;
+    }
+
+    void header(size_t n, unsigned fix, unsigned b16, unsigned b32) {
+        if (n < 16)          m_out += (char)(fix | n);
+        else if (n <= 65535) { m_out += (char)b16; be(n, 2); }
+        else                 { m_out += (char)b32; be(n, 4); }
+    }
+
+    void str(std::string_view s) {
+        size_t n = s.size();
+        if (n < 32)               m_out += (char)(0xa0 | n);
+        else if (n <= 0xff)       { m_out += (char)0xd9; be(n, 1); }
+        else if (n <= 0xffff)     { m_out += (char)0xda; be(n, 2); }
+        else                      { m_out += (char)0xdb; be(n, 4); }
+        m_out.append(s.data(), n);
+    }
+
+    Packer& open(unsigned char marker) {
+        item();
+        m_out += (char)marker;
+        m_levels.push_back({ m_out.size(), 0 });
+        m_out.append(4, '\0');
+        return *this;
+    }
+
+    Packer& close() {
+        Level lv = m_levels.back();
+        m_levels.pop_back();
+        if (lv.countPos != npos) {
+            for (int i = 0; i < 4; ++i)
+                m_out[lv.countPos + i] = (char)(unsigned char)(lv.count >> ((3 - i) * 8));
+        }
+        return *this;
+    }
+};
+
+// ─── Unpacker ────────────────────────────────────────────────────────────────
+// 产出与 sj::Reader 相同的事件序列：map 对应 StartObject / Key / ... / EndObject，
+// 键必须为 str 类型。str() 返回指向输入缓冲区的视图，在输入有效期间一直可用。
+// bin / ext 等 JSON 无对应的类型以及截断的输入会抛出 std::runtime_error
+class Unpacker {
+public:
+    explicit Unpacker(std::string_view bytes)
+        : m_p((const unsigned char*)bytes.data()), m_end(m_p + bytes.size()) {}
+
+    Event next() {
+        if (!m_stack.empty()) {
+            Frame& f = m_stack.back();
+            if (f.remaining == 0) {
+                bool isMap = f.isMap;
+                m_stack.pop_back();
+                return isMap ? Event::EndObject : Event::EndArray;
+            }
+            if (f.isMap && f.expectKey) {
+                f.expectKey = false;
+                if (!readStr()) throw std::runtime_error("MessagePack map key must be a string");
+                return Event::Key;
+            }
+            --f.remaining;
+            if (f.isMap) f.expectKey = true;
+        } else if (m_done) {
+            if (m_p != m_end) throw std::runtime_error("Trailing bytes after MessagePack value");
+            return Event::End;
+        } else {
+            m_done = true;
+        }
+        return readValue();
+    }
+
+    std::string_view str() const { return m_str; }
+    double  number()     const { return m_isInt ? (double)m_int : m_num; }
+    bool    is_integer() const { return m_isInt; }
+    int64_t integer()    const { return m_isInt ? m_int : sj::detail::saturateInt64(m_num); }
+    bool    boolean()    const { return m_bool; }
+    size_t  depth()      const { return m_stack.size(); }
+    // 刚返回 StartObject / StartArray 时为其元素数（map 为键值对数），可据此预留空间
+    size_t  length()     const { return m_stack.empty() ? 0 : m_stack.back().remaining; }
+
+    void skip(Event e) {
+        if (e != Event::StartObject && e != Event::StartArray) return;
+        size_t target = m_stack.size() - 1;
+        while (m_stack.size() > target) next();
+    }
+    void skipValue() { skip(next()); }
+
+private:
+    struct Frame {
+        uint32_t remaining;   // 尚未读取的元素数（map 为键值对数）
+        bool     isMap;
+        bool     expectKey;
+    };
+
+    const unsigned char* m_p;
+    const unsigned char* m_end;
+    std::vector<Frame>   m_stack;
+    bool                 m_done = false;
+
+    std::string_view m_str;
+    double           m_num = 0;
+    int64_t          m_int = 0;
+    bool             m_isInt = false;
+    bool             m_bool = false;
+
+    void need(size_t n) const {
+        if ((size_t)(m_end - m_p) < n) throw std::runtime_error("Truncated MessagePack input");
+    }
+    uint64_t be(int bytes) {
+        need((size_t)bytes);
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v = (v << 8) | *m_p++;
+        return v;
+    }
+
+    bool readStr() {
+        need(1);
+        unsigned char b = *m_p;
+        size_t n;
+        if ((b & 0xe0) == 0xa0) { ++m_p; n = b & 0x1f; }
+        else if (b == 0xd9)     { ++m_p; n = (size_t)be(1); }
+        else if (b == 0xda)     { ++m_p; n = (size_t)be(2); }
+        else if (b == 0xdb)     { ++m_p; n = (size_t)be(4); }
+        else return false;
+        need(n);
+        m_str = std::string_view((const char*)m_p, n);
+        m_p += n;
+        return true;
+    }
+
+    Event integer(int64_t v)  { m_isInt = true; m_int = v; return Event::Number; }
+    Event unsignedInt(uint64_t v) {
+        if (v <= (uint64_t)INT64_MAX) return integer((int64_t)v);
+        m_isInt = false;
+        m_num = (double)v;
+        return Event::Number;
+    }
+
+    Event container(uint32_t n, bool isMap) {
+        if (m_stack.size() >= (size_t)detail::kMaxDepth) throw std::runtime_error("Nesting too deep");
+        // 每个元素至少占 1 字节，计数超过剩余字节数的输入必然被截断
+        if ((uint64_t)n * (isMap ? 2 : 1) > (uint64_t)(m_end - m_p))
+            throw std::runtime_error("Truncated MessagePack input");
+        m_stack.push_back({ n, isMap, isMap });
+        return isMap ? Event::StartObject : Event::StartArray;
+    }
+
+    Event readValue() {
+        if (readStr()) return Event::String;
+        need(1);
+        unsigned char b = *m_p++;
+        if (b < 0x80)           return integer(b);
+        if (b >= 0xe0)          return integer((int8_t)b);
+        if ((b & 0xf0) == 0x80) return container(b & 0x0f, true);
+        if ((b & 0xf0) == 0x90) return container(b & 0x0f, false);
+        switch (b) {
+        case 0xc0: return Event::Null;
+        case 0xc2: m_bool = false; return Event::Bool;
+        case 0xc3: m_bool = true;  return Event::Bool;
+        case 0xcc: return integer((int64_t)be(1));
+        case 0xcd: return integer((int64_t)be(2));
+        case 0xce: return integer((int64_t)be(4));
+        case 0xcf: return unsignedInt(be(8));
+        case 0xd0: return integer((int8_t)be(1));
+        case 0xd1: return integer((int16_t)be(2));
+        case 0xd2: return integer((int32_t)be(4));
+        case 0xd3: return integer((int64_t)be(8));
+        case 0xca: {
+            uint32_t bits = (uint32_t)be(4);
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            m_isInt = false; m_num = f;
+            return Event::Number;
+        }
+        case 0xcb: {
+            uint64_t bits = be(8);
+            std::memcpy(&m_num, &bits, sizeof(m_num));
+            m_isInt = false;
+            return Event::Number;
+        }
+        case 0xdc: return container((uint32_t)be(2), false);
+        case 0xdd: return container((uint32_t)be(4), false);
+        case 0xde: return container((uint32_t)be(2), true);
+        case 0xdf: return container((uint32_t)be(4), true);
+        default:
+            throw std::runtime_error("Unsupported MessagePack type");
+        }
+    }
+};
+
+// ─── Value 树编解码 ──────────────────────────────────────────────────────────
+inline void encode(std::string& out, const Value& v) {
+    Packer(out).value(v);
+}
+
+inline std::string encode(const Value& v) {
+    std::string out;
+    encode(out, v);
+    return out;
+}
+
+namespace detail {
+
+inline Value build(Unpacker& u, Event e, std::pmr::memory_resource* mr, KeyPool* keys) {
+    switch (e) {
+    case Event::StartObject: {
+        Object obj(mr, keys);
+        for (Event k = u.next(); k == Event::Key; k = u.next()) {
+            std::string_view key = u.str();   // 指向输入缓冲区，解码值期间保持有效
+            obj[key] = build(u, u.next(), mr, keys);
+        }
+        return Value(std::move(obj));
+    }
+    case Event::StartArray: {
+        Array arr(mr);
+        for (Event x = u.next(); x != Event::EndArray; x = u.next()) arr.push_back(build(u, x, mr, keys));
+        return Value(std::move(arr));
+    }
+    case Event::String: return Value(u.str(), mr);
+    case Event::Number: return u.is_integer() ? Value((long long)u.integer()) : Value(u.number());
+    case Event::Bool:   return Value(u.boolean());
+    case Event::Null:   return Value();
+    default: throw std::runtime_error("Unexpected MessagePack event");
+    }
+}
+
+} // namespace detail
+
+// 解码出的字符串与容器从 mr 分配，对象键驻留在 keys 中（可传入 Document::resource() 与
+// Document::keys() 使用其 arena 与键池）；keys 为空时各对象自行保存键
+inline Value decode(std::string_view bytes, std::pmr::memory_resource* mr = std::pmr::get_default_resource(),
+                    KeyPool* keys = nullptr) {
+    Unpacker u(bytes);
+    Value v = detail::build(u, u.next(), mr, keys);
+    if (u.next() != Event::End) throw std::runtime_error("Trailing bytes after MessagePack value");
+    return v;
+}
+
+// ─── 结构体编解码 ────────────────────────────────────────────────────────────
+// 与 sj::encode / sj::decode 对应，沿用同一张 SJ_FIELDS 字段表；对象以成员名为键，
+// 因此增删成员后旧数据仍可读出
+template <class T>
+void encode(Packer& p, const T& v) {
+    if constexpr (sj::detail::HasFields<T>::value) {
+        p.startObject(sj::detail::fieldCount<T>());
+        std::apply([&](const auto&... f) { ((p.key(f.name), encode(p, v.*(f.member))), ...); },
+                   sj::detail::fieldsOf<T>());
+        p.endObject();
+    } else if constexpr (sj::detail::IsVector<T>::value) {
+        p.startArray(v.size());
+        for (const auto& e : v) encode(p, e);
+        p.endArray();
+    } else {
+        p.value(v);
+    }
+}
+
+// 从 Unpacker 读取下一个值到 out，返回被赋值的成员掩码；该值不是 map 时跳过并返回 0
+template <class T>
+FieldMask decode(Unpacker& u, T& out) {
+    Event e = u.next();
+    if (e != Event::StartObject) { u.skip(e); return 0; }
+    return sj::detail::decodeObject(u, out);
+}
+
+template <class T>
+FieldMask decode(std::string_view bytes, T& out) {
+    Unpacker u(bytes);
+    FieldMask mask = decode(u, out);
+    if (u.next() != Event::End) throw std::runtime_error("Trailing bytes after MessagePack value");
+    return mask;
+}
+
+// ─── 按位置编解码 ────────────────────────────────────────────────────────────
+// 结构体写成按 SJ_FIELDS 顺序排列的数组，不含成员名，解码时无需逐个比较键。
+// 字段表增删或调整顺序后旧数据不能读出，须由调用方以字段表指纹等方式保证双方一致（如配置缓存）
+template <class T>
+void encodeTuple(Packer& p, const T& v) {
+    if constexpr (sj::detail::HasFields<T>::value) {
+        p.startArray(sj::detail::fieldCount<T>());
+        std::apply([&](const auto&... f) { (encodeTuple(p, v.*(f.member)), ...); }, sj::detail::fieldsOf<T>());
+        p.endArray();
+    } else if constexpr (sj::detail::IsVector<T>::value) {
+        p.startArray(v.size());
+        for (const auto& e : v) encodeTuple(p, e);
+        p.endArray();
+    } else {
+        p.value(v);
+    }
+}
+
+// 以事件 e 开头的值解码到 out。与 encodeTuple 的结构不符时抛出 std::runtime_error，
+// 不做 decode 那样的容错；全部成员都已赋值，sj_decoded 收到的掩码包含每个成员
+template <class T>
+void decodeTuple(Unpacker& u, Event e, T& out) {
+    if constexpr (sj::detail::HasFields<T>::value) {
+        constexpr size_t n = sj::detail::fieldCount<T>();
+        if (e != Event::StartArray || u.length() != n) throw std::runtime_error("MessagePack tuple does not match SJ_FIELDS");
+        std::apply([&](const auto&... f) { (decodeTuple(u, u.next(), out.*(f.member)), ...); }, sj::detail::fieldsOf<T>());
+        u.next();   // EndArray
+        if constexpr (sj::detail::HasDecodedHook<T>::value)
+            sj_decoded(out, n == 64 ? ~FieldMask(0) : ((FieldMask)1 << n) - 1);
+    } else if constexpr (sj::detail::IsVector<T>::value) {
+        if (e != Event::StartArray) throw std::runtime_error("MessagePack tuple does not match SJ_FIELDS");
+        out.clear();
+        out.resize(u.length());
+        for (auto& item : out) decodeTuple(u, u.next(), item);
+        u.next();   // EndArray
+    } else {
+        if (!sj::decodeValue(u, e, out)) throw std::runtime_error("MessagePack tuple does not match SJ_FIELDS");
+    }
+}
+
+template <class T>
+void decodeTuple(std::string_view bytes, T& out) {
+    Unpacker u(bytes);
+    decodeTuple(u, u.next(), out);
+    if (u.next() != Event::End) throw std::runtime_error("Trailing bytes after MessagePack value");
+}
+
+} // namespace msgpack
+} // namespace sj
@@ -0,0 +1,768 @@
+// Supervisor.cpp  -  与平台无关的进程守护核心
+#include "Supervisor.h"
+#include <chrono>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <cstdarg>
+#include <cstdio>
+
+Supervisor::Supervisor(IProcessBackend& backend, ISupervisorHost& host)
+    : m_backend(backend), m_host(host) {}
+
+Supervisor::~Supervisor() {
+    // 先停启动线程池：执行中的启动任务还可能挂定时器，时间轮此时仍然有效
+    m_launcher.stop();
+}
+
+// ─── 日志与通知 ───────────────────────────────────────────────────────────────
+void Supervisor::logf(const char* fmt, ...) {
+    char buf[2048];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    m_host.log(buf);
+}
+
+void Supervisor::notifyStatus(const std::string& id, ProcStatus s) {
+    m_host.statusChanged(id, s);
+}
+
+// ─── 同步配置（将配置中的进程补充到运行时表）──────────────────────────────────
+void Supervisor::syncConfig() {
+    ConfigPtr snap = m_host.config();
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const auto& pc : snap->config.processes) {
+        if (m_procs.find(pc.id) == m_procs.end()) {
+            ManagedProcess mp;
+            mp.id = pc.id;
+            mp.status = ProcStatus::Stopped;
+            m_procs[pc.id] = std::move(mp);
+        }
+    }
+}
+
+// ─── 应用配置热重载差异 ──────────────────────────────────────────────────────
+void Supervisor::applyConfigDiff(const ConfigDiff& diff) {
+    syncConfig();
+    for (const auto& id : diff.removed) stopProcess(id);
+
+    for (const auto& id : diff.relaunch) {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto it = m_procs.find(id);
+            if (it == m_procs.end()) continue;
+            // 未运行的进程下次启动时自然读取新配置
+            if (it->second.status != ProcStatus::Running && it->second.status != ProcStatus::Starting)
+                continue;
+            it->second.restartPending = true;
+        }
+        logf("[进程] %-20s  配置已变更，重新启动", id.c_str());
+        stopProcess(id);
+        // 尚在等待或排队中的进程没有句柄，stopProcess 直接置为已停止，不会再经过 onProcessExited；
+        // 正在创建的进程登记后会被立即结束，退出时照常按 restartPending 重新启动
+        bool stoppedNow = false;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto& mp = m_procs[id];
+            if (mp.restartPending && mp.status == ProcStatus::Stopped && !mp.launching) {
+                mp.restartPending = false;
+                stoppedNow = true;
+            }
+        }
+        if (stoppedNow) startProcess(id);
+    }
+
+    ConfigPtr snap = m_host.config();
+    for (const auto& id : diff.added) {
+        const ProcessConfig* p = snap->find(id);
+        if (p && p->enabled) startProcess(id);
+    }
+}
+
+// ─── 查询进程当前状态 ────────────────────────────────────────────────────────
+ProcStatus Supervisor::getStatus(const std::string& id) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_procs.find(id);
+    if (it == m_procs.end()) return ProcStatus::Stopped;
+    return it->second.status;
+}
+
+// ─── 查询进程 PID ─────────────────────────────────────────────────────────────
+uint32_t Supervisor::getPid(const std::string& id) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_procs.find(id);
+    if (it == m_procs.end()) return 0;
+    return it->second.pid;
+}
+
+// ─── 查询守护重启退避状态 ────────────────────────────────────────────────────
+RestartState Supervisor::getRestartState(const std::string& id) {
+    RestartState st;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_procs.find(id);
+    if (it == m_procs.end()) return st;
+    const ManagedProcess& mp = it->second;
+    st.attempt = mp.crashStreak;
+    st.delayMs = mp.backoffMs;
+    st.recent  = (int)mp.restartTimes.size();
+    st.tripped = mp.tripped;
+    if (mp.status == ProcStatus::Restarting && mp.timer) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            mp.restartAt - std::chrono::steady_clock::now()).count();
+        st.dueInMs = std::max<int64_t>(0, left);
+    }
+    return st;
+}
+
+// ─── 刷新脚本子进程 PID（脚本启动后由时间轮调用）──────────────────────────────
+// 命令解释器的 PID 对用户无意义：找到它的第一个业务子进程后更新 mp.pid 并通知前端刷新显示
+void Supervisor::probeChildPid(const std::string& id, uint32_t rootPid, int attempt) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        // 进程已停止或已重新启动，不必再找
+        if (it == m_procs.end() || it->second.pid != rootPid) return;
+    }
+
+    std::vector<uint32_t> children = m_backend.listChildren(rootPid);
+    if (children.empty()) {
+        // 等待子进程启动，最多重试 5 次，每次间隔 1.5 秒；仍未找到则保留解释器 PID
+        if (attempt < 5) {
+            m_timers.schedule(std::chrono::milliseconds(1500), [this, id, rootPid, attempt](TimerWheel::TimerId) {
+                probeChildPid(id, rootPid, attempt + 1);
+            });
+        }
+        return;
+    }
+    uint32_t childPid = children.front();
+
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        // 仅当 PID 仍为原始解释器 PID 时才更新（避免进程已停止后误写）
+        if (it == m_procs.end() || it->second.pid != rootPid) return;
+        it->second.pid = childPid;
+    }
+    // 推送状态更新，让前端刷新 PID 显示
+    notifyStatus(id, ProcStatus::Running);
+    logf("[进程] %-20s  子进程 PID 更新: %u", id.c_str(), (unsigned)childPid);
+}
+
+// ─── 提交启动任务 ────────────────────────────────────────────────────────────
+// 并发上限随配置调整，优先级取自当前配置；batch 非空时计入这次全部启动的统计
+void Supervisor::enqueueLaunch(const std::string& id, const BatchPtr& batch) {
+    ConfigPtr snap = m_host.config();
+    const ProcessConfig* p = snap->find(id);
+    m_launcher.setLimit((unsigned)std::max(0, snap->config.launchConcurrency));
+    if (batch) {
+        ++batch->total;
+        ++batch->pending;
+    }
+    m_launcher.submit(p ? p->priority : 0, [this, id, batch]() {
+        bool ok = launchNow(id);
+        if (batch) finishBatch(*batch, ok);
+    });
+}
+
+void Supervisor::finishBatch(LaunchBatch& batch, bool ok) {
+    if (!ok) ++batch.failed;
+    if (--batch.pending != 0 || batch.total == 0) return;
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - batch.start).count();
+    size_t total  = batch.total;
+    size_t failed = batch.failed;
+    if (failed)
+        logf("[进程] 全部启动完成  %zu 个进程用时 %lld ms，其中 %zu 个启动失败", total, ms, failed);
+    else
+        logf("[进程] 全部启动完成  %zu 个进程用时 %lld ms", total, ms);
+}
+
+// ─── 立即启动进程（启动线程池中执行）──────────────────────────────────────────
+// 返回 false 表示启动失败；排队期间已被停止或已由另一次启动接手时直接放弃，不算失败
+bool Supervisor::launchNow(const std::string& id) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto& mp = m_procs[id];
+        if (mp.guardStopped || mp.launching || mp.proc ||
+            (mp.status != ProcStatus::Starting && mp.status != ProcStatus::Restarting))
+            return true;
+        mp.launching = true;
+    }
+
+    // 持有快照即可安全引用其中的配置，不受 UI 线程同时增删的影响
+    ConfigPtr snap = m_host.config();
+    const ProcessConfig* found = snap->find(id);
+    if (!found) {
+        // 排队期间条目已被删除
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto& mp = m_procs[id];
+            mp.status    = ProcStatus::Failed;
+            mp.launching = false;
+        }
+        logf("[进程] %-20s  启动失败  配置中已没有该条目", id.c_str());
+        notifyStatus(id, ProcStatus::Failed);
+        dropDependents(id, ProcStatus::Failed);
+        return false;
+    }
+    const ProcessConfig& cfg = *found;
+
+    SpawnSpec spec;
+    spec.path       = cfg.path;
+    spec.args       = cfg.args;
+    spec.script     = cfg.type == "bat";
+    spec.background = cfg.background;
+    // 提取 bat/exe 所在目录作为工作目录，确保相对路径能正确解析
+    auto pos = cfg.path.find_last_of("\\/");
+    if (pos != std::string::npos) spec.workDir = cfg.path.substr(0, pos);
+
+    if (cfg.background) logf("[进程] %-20s  后台模式（无控制台窗口）", id.c_str());
+    logf("[进程] %-20s  正在启动  %s %s", id.c_str(), cfg.path.c_str(), cfg.args.c_str());
+
+    std::string error;
+    std::unique_ptr<IProcess> proc = m_backend.spawn(spec, error);
+    if (!proc) {
+        logf("[进程] %-20s  启动失败  %s", id.c_str(), error.c_str());
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto& mp = m_procs[id];
+            mp.status    = ProcStatus::Failed;
+            mp.launching = false;
+        }
+        notifyStatus(id, ProcStatus::Failed);
+        dropDependents(id, ProcStatus::Failed);
+        return false;
+    }
+
+    uint32_t pid = proc->pid();
+    std::unique_ptr<IProcess> prev;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto& mp = m_procs[id];
+        prev      = std::move(mp.proc);   // 上一次的进程对象在锁外释放
+        mp.proc   = std::move(proc);
+        mp.pid       = pid;
+        mp.status    = ProcStatus::Running;  // 标记为运行中
+        mp.launching = false;
+        mp.startedAt = std::chrono::steady_clock::now();
+        // 先登记再等待，退出回调无论多快都能在表中找到这个进程
+        mp.proc->waitForExit([this, id, pid](uint32_t exitCode) {
+            m_host.processExited(id, pid, exitCode);
+        });
+        // 启动途中用户已经停止：立即结束，退出后照常走 onProcessExited 置为已停止
+        if (mp.guardStopped) mp.proc->killTree();
+    }
+    prev.reset();
+
+    notifyStatus(id, ProcStatus::Running);
+    logf("[进程] %-20s  已启动  PID=%u", id.c_str(), (unsigned)pid);
+    releaseDependents(id);
+
+    // 脚本：解释器 PID 对用户无意义，稍后探测真正的子进程 PID 并更新显示
+    if (spec.script) {
+        m_timers.schedule(std::chrono::milliseconds(1500), [this, id, pid](TimerWheel::TimerId) {
+            probeChildPid(id, pid, 1);
+        });
+    }
+
+    return true;
+}
+
+// ─── 定时器到期（定时器线程）──────────────────────────────────────────────────
+// 延迟启动与守护重启共用：只认仍登记在 mp.timer 上的那一个，已取消或被新一次启动
+// 取代的定时器即使回调已经在路上也直接忽略，不会重复启动。
+// 守护重启按到期时的配置再判断一次：等待期间守护被关闭或条目被删除则不再重启
+void Supervisor::onTimer(const std::string& id, TimerWheel::TimerId timer) {
+    ConfigPtr snap = m_host.config();
+    bool cancelled = false;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        if (it == m_procs.end() || it->second.timer != timer) return;
+        ManagedProcess& mp = it->second;
+        mp.timer = 0;
+        if (mp.status == ProcStatus::Restarting) {
+            const ProcessConfig* cfg = snap->find(id);
+            if (!cfg || !cfg->guardEnabled) {
+                mp.status      = ProcStatus::Stopped;
+                mp.crashStreak = 0;
+                cancelled      = true;
+            }
+        }
+    }
+    if (cancelled) {
+        logf("[进程] %-20s  守护已关闭，取消等待中的重启", id.c_str());
+        notifyStatus(id, ProcStatus::Stopped);
+        dropDependents(id, ProcStatus::Stopped);
+        return;
+    }
+    enqueueLaunch(id, nullptr);
+}
+
+// ─── 启动进程 ────────────────────────────────────────────────────────────────
+bool Supervisor::startProcess(const std::string& id) {
+    return startGroup({ id }, {}, nullptr) > 0;
+}
+
+// ─── 按依赖关系启动一组条目 ──────────────────────────────────────────────────
+// roots 连同它们尚未运行的依赖一起按 Kahn 算法分层：没有待启动依赖的条目立即开始，
+// 其余条目记下还没运行的依赖，依赖进入运行状态时由 releaseDependents 放行，不靠固定延迟等待。
+// skipped 中的条目不会被拉起，依赖它们的条目直接失败。返回 roots 中被接受的条目数
+size_t Supervisor::startGroup(const std::vector<std::string>& roots,
+                              const std::map<std::string, std::string>& skipped, const BatchPtr& batch) {
+    ConfigPtr snap = m_host.config();
+    std::vector<const ProcessConfig*> ready;                      // 锁外开始启动
+    std::vector<std::pair<std::string, std::string>> waiting;    // (id, 等待的依赖)
+    std::vector<std::pair<std::string, std::string>> failed;     // (id, 原因)
+    std::vector<std::string> notes;
+    std::string cycle;
+    size_t accepted = 0, waves = 0, planned = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+
+        // 本次要启动的条目：roots 中未在运行的，加上它们已停止或失败的依赖（逐层展开）
+        std::vector<const ProcessConfig*> nodes;
+        std::unordered_map<std::string, size_t> index;
+        auto idle = [&](const std::string& id) {
+            ProcStatus s = m_procs[id].status;
+            return s == ProcStatus::Stopped || s == ProcStatus::Failed;
+        };
+        for (const auto& id : roots) {
+            const ProcessConfig* p = snap->find(id);
+            if (!p || index.count(id)) continue;
+            ProcStatus s = m_procs[id].status;
+            if (s == ProcStatus::Running || s == ProcStatus::Starting) continue;
+            index.emplace(id, nodes.size());
+            nodes.push_back(p);
+            ++accepted;
+        }
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            for (const auto& dep : nodes[i]->dependsOn) {
+                const ProcessConfig* d = snap->find(dep);
+                if (!d || index.count(dep) || skipped.count(dep) || !idle(dep)) continue;
+                index.emplace(dep, nodes.size());
+                nodes.push_back(d);
+            }
+        }
+
+        // 建图：组内依赖是边；已运行的依赖直接满足，启动途中（启动中 / 重启中）的依赖只需等待
+        size_t n = nodes.size();
+        std::vector<std::vector<size_t>> deps(n), users(n);
+        std::vector<std::vector<std::string>> waitFor(n);
+        std::vector<std::string> reason(n);   // 非空表示无法启动
+        std::vector<size_t> indeg(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            std::set<std::string> seen;
+            for (const auto& dep : nodes[i]->dependsOn) {
+                if (!seen.insert(dep).second) continue;
+                auto it = index.find(dep);
+                if (it != index.end()) {
+                    deps[i].push_back(it->second);
+                    users[it->second].push_back(i);
+                    ++indeg[i];
+                    waitFor[i].push_back(dep);
+                } else if (!snap->find(dep)) {
+                    notes.push_back(nodes[i]->id + "  依赖的进程 " + dep + " 不存在，已忽略");
+                } else if (m_procs[dep].status == ProcStatus::Running) {
+                    continue;
+                } else if (skipped.count(dep)) {
+                    reason[i] = "依赖的进程 " + dep + " 配置校验未通过";
+                } else {
+                    waitFor[i].push_back(dep);
+                }
+            }
+        }
+
+        // 逐层剥离入度为 0 的条目；无法启动的原因沿边传给依赖它的条目
+        std::vector<char> done(n, 0);
+        std::vector<size_t> wave;
+        for (size_t i = 0; i < n; ++i)
+            if (indeg[i] == 0) wave.push_back(i);
+        while (!wave.empty()) {
+            ++waves;
+            std::vector<size_t> nextWave;
+            for (size_t i : wave) {
+                done[i] = 1;
+                for (size_t j : users[i]) {
+                    if (!reason[i].empty() && reason[j].empty())
+                        reason[j] = "依赖的进程 " + nodes[i]->id + " 无法启动";
+                    if (--indeg[j] == 0) nextWave.push_back(j);
+                }
+            }
+            wave.swap(nextWave);
+        }
+
+        // 剩下的条目都在环上或依赖环上的条目：沿未剥离的依赖走到重复为止，找出一个环用于日志
+        auto first = std::find(done.begin(), done.end(), 0);
+        if (first != done.end()) {
+            std::vector<size_t> path;
+            std::vector<size_t> pos(n, SIZE_MAX);
+            size_t v = (size_t)(first - done.begin());
+            while (pos[v] == SIZE_MAX) {
+                pos[v] = path.size();
+                path.push_back(v);
+                v = *std::find_if(deps[v].begin(), deps[v].end(), [&](size_t d) { return !done[d]; });
+            }
+            for (size_t k = pos[v]; k < path.size(); ++k) cycle += nodes[path[k]]->id + " → ";
+            cycle += nodes[v]->id;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const std::string& id = nodes[i]->id;
+            ManagedProcess& mp = m_procs[id];
+            // 等待中的守护重启由这次启动取代
+            if (mp.timer) m_timers.cancel(mp.timer);
+            mp.timer = 0;
+            if (!done[i] || !reason[i].empty()) {
+                mp.status = ProcStatus::Failed;
+                failed.emplace_back(id, done[i] ? reason[i] : "存在循环依赖");
+                continue;
+            }
+            ++planned;
+            mp.guardStopped = false;
+            mp.status = ProcStatus::Starting;
+            // 用户重新启动：退避与频繁崩溃判定从头计算
+            mp.crashStreak = 0;
+            mp.backoffMs   = 0;
+            mp.tripped     = false;
+            mp.restartTimes.clear();
+            mp.waitFor = std::move(waitFor[i]);
+            if (mp.waitFor.empty()) {
+                ready.push_back(nodes[i]);
+                continue;
+            }
+            std::string list;
+            for (const auto& dep : mp.waitFor) {
+                m_dependents[dep].push_back(id);
+                list += (list.empty() ? "" : ", ") + dep;
+            }
+            mp.waitBatch = batch;
+            if (batch) ++batch->pending;
+            waiting.emplace_back(id, std::move(list));
+        }
+    }
+
+    for (const auto& note : notes) logf("[进程] %s", note.c_str());
+    if (!cycle.empty()) logf("[进程] 循环依赖：%s", cycle.c_str());
+    if (!waiting.empty()) logf("[进程] 启动计划  %zu 个进程按依赖分 %zu 层", planned, waves);
+    for (const auto& [id, why] : failed) {
+        logf("[进程] %-20s  无法启动：%s", id.c_str(), why.c_str());
+        notifyStatus(id, ProcStatus::Failed);
+        if (batch) {
+            ++batch->total;
+            ++batch->failed;
+        }
+    }
+    for (const auto& [id, list] : waiting) {
+        logf("[进程] %-20s  等待依赖运行：%s", id.c_str(), list.c_str());
+        notifyStatus(id, ProcStatus::Starting);
+    }
+    // 按优先级提交：线程池在提交过程中就开始取任务，先提交的总是最重要的
+    std::stable_sort(ready.begin(), ready.end(),
+                     [](const ProcessConfig* a, const ProcessConfig* b) { return a->priority > b->priority; });
+    for (const ProcessConfig* p : ready) {
+        notifyStatus(p->id, ProcStatus::Starting);
+        proceed(p->id, batch);
+    }
+    return accepted;
+}
+
+// ─── 依赖已就绪，开始启动 ────────────────────────────────────────────────────
+// 设有延迟则挂到时间轮上，到期后再排队；期间已被停止或重新规划的条目不再启动
+void Supervisor::proceed(const std::string& id, const BatchPtr& batch) {
+    ConfigPtr snap = m_host.config();
+    const ProcessConfig* p = snap->find(id);
+    int delay = p ? p->delaySeconds : 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto& mp = m_procs[id];
+        if (mp.guardStopped || mp.status != ProcStatus::Starting || !mp.waitFor.empty() || mp.timer) return;
+        if (delay > 0) {
+            mp.timer = m_timers.schedule(std::chrono::seconds(delay), [this, id](TimerWheel::TimerId t) {
+                onTimer(id, t);
+            });
+        }
+    }
+    if (delay > 0) {
+        logf("[进程] %-20s  准备启动（延迟 %d 秒）", id.c_str(), delay);
+    } else {
+        logf("[进程] %-20s  准备启动", id.c_str());
+        enqueueLaunch(id, batch);
+    }
+}
+
+// ─── 依赖进入运行状态：放行等它的条目 ────────────────────────────────────────
+void Supervisor::releaseDependents(const std::string& id) {
+    std::vector<std::pair<std::string, BatchPtr>> ready;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_dependents.find(id);
+        if (it == m_dependents.end()) return;
+        // 启动途中已被停止的进程马上会被结束，不算就绪；等它的条目由 stopProcess 取消
+        const ManagedProcess& self = m_procs[id];
+        if (self.status != ProcStatus::Running || self.guardStopped) return;
+        std::vector<std::string> users = std::move(it->second);
+        m_dependents.erase(it);
+        for (const auto& user : users) {
+            ManagedProcess& mp = m_procs[user];
+            auto w = std::find(mp.waitFor.begin(), mp.waitFor.end(), id);
+            if (w == mp.waitFor.end()) continue;   // 已被停止或重新规划
+            mp.waitFor.erase(w);
+            if (mp.waitFor.empty()) ready.emplace_back(user, std::move(mp.waitBatch));
+        }
+    }
+    for (auto& [user, batch] : ready) {
+        proceed(user, batch);
+        if (batch) finishBatch(*batch, true);   // 释放等待期间持有的计数
+    }
+}
+
+// ─── 依赖启动失败或被停止：等它的条目（及再往后等它们的条目）不再启动 ──────────
+void Supervisor::dropDependents(const std::string& id, ProcStatus status) {
+    struct Dropped { std::string id, cause; BatchPtr batch; };
+    std::vector<Dropped> dropped;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        std::vector<std::string> causes{ id };
+        for (size_t i = 0; i < causes.size(); ++i) {
+            auto it = m_dependents.find(causes[i]);
+            if (it == m_dependents.end()) continue;
+            std::vector<std::string> users = std::move(it->second);
+            m_dependents.erase(it);
+            for (const auto& user : users) {
+                ManagedProcess& mp = m_procs[user];
+                if (std::find(mp.waitFor.begin(), mp.waitFor.end(), causes[i]) == mp.waitFor.end()) continue;
+                mp.waitFor.clear();
+                mp.status = status;
+                dropped.push_back(Dropped{ user, causes[i], std::move(mp.waitBatch) });
+                causes.push_back(user);
+            }
+        }
+    }
+    bool fail = status == ProcStatus::Failed;
+    for (auto& d : dropped) {
+        logf("[进程] %-20s  依赖的进程 %s %s，不再启动", d.id.c_str(), d.cause.c_str(), fail ? "启动失败" : "已停止");
+        notifyStatus(d.id, status);
+        if (!d.batch) continue;
+        if (fail) ++d.batch->total;
+        finishBatch(*d.batch, !fail);
+    }
+}
+
+// ─── 停止进程 ────────────────────────────────────────────────────────────────
+bool Supervisor::stopProcess(const std::string& id) {
+    bool     running = false;
+    uint32_t curPid  = 0;
+    BatchPtr waitBatch;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        if (it == m_procs.end()) return false;
+        ManagedProcess& mp = it->second;
+        mp.guardStopped = true;
+        curPid = mp.pid;
+        // 取消等待中的延迟启动或守护重启
+        if (mp.timer) m_timers.cancel(mp.timer);
+        mp.timer = 0;
+        // 取消等待依赖
+        mp.waitFor.clear();
+        waitBatch = std::move(mp.waitBatch);
+        if (mp.proc) {
+            // 级联终止整个进程树；进程退出后在 onProcessExited 中清理
+            mp.proc->killTree();
+            running = true;
+        } else {
+            // 进程已不在运行，直接标记为已停止
+            mp.status = ProcStatus::Stopped;
+        }
+    }
+    logf("[进程] %-20s  用户停止  PID=%u", id.c_str(), (unsigned)curPid);
+    if (!running) notifyStatus(id, ProcStatus::Stopped);
+    if (waitBatch) finishBatch(*waitBatch, true);
+    dropDependents(id, ProcStatus::Stopped);
+    return true;
+}
+
+// ─── 全部启动 / 全部停止 ─────────────────────────────────────────────────────
+void Supervisor::startAll() {
+    syncConfig();
+    std::vector<std::string> ids;
+    std::map<std::string, std::string> skipped;
+    bool stale = false;
+    {
+        ConfigPtr     snap  = m_host.config();
+        ValidationPtr check = m_host.validation();
+        for (const auto& pc : snap->config.processes) {
+            if (!pc.enabled) continue;
+            if (const ConfigIssue* issue = check->issueOf(pc)) {
+                // 校验之后文件可能已经补齐：只对未通过的少数条目重新检查一次
+                std::string msg = issue->configError ? issue->message : m_host.checkPath(pc.path);
+                if (!msg.empty()) { skipped[pc.id] = std::move(msg); continue; }
+                stale = true;
+            }
+            ids.push_back(pc.id);
+        }
+    }
+    if (stale) m_host.revalidate();
+
+    for (const auto& [id, msg] : skipped) {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto& mp = m_procs[id];
+            if (mp.status != ProcStatus::Stopped && mp.status != ProcStatus::Failed) continue;
+            mp.status = ProcStatus::Failed;
+        }
+        logf("[进程] %-20s  配置校验未通过，跳过启动：%s", id.c_str(), msg.c_str());
+        notifyStatus(id, ProcStatus::Failed);
+    }
+    // 延迟启动的条目由时间轮到期后再排队，不计入本次统计
+    auto batch = std::make_shared<LaunchBatch>();
+    startGroup(ids, skipped, batch);
+    finishBatch(*batch, true);   // 释放 startAll 自身持有的计数
+}
+
+void Supervisor::stopAll() {
+    std::vector<std::string> ids;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        for (auto& [id, mp] : m_procs) ids.push_back(id);
+    }
+    for (const auto& id : ids) stopProcess(id);
+}
+
+// ─── 守护重启退避 ────────────────────────────────────────────────────────────
+// 第 1 次为 guardDelaySeconds，之后按它（为 0 时按 1 秒）逐次翻倍，不超过 backoffMaxSeconds。
+// 秒数最大约 2^31，换算成毫秒仍远小于 int64 上限；翻倍前先与 cap >> k 比较，左移不会溢出
+int64_t Supervisor::backoffBaseMs(const ProcessConfig& cfg, int streak) {
+    int64_t base = std::max(0, cfg.guardDelaySeconds) * int64_t(1000);
+    int64_t cap  = std::max(base, std::max(0, cfg.backoffMaxSeconds) * int64_t(1000));
+    if (streak <= 1) return base;
+    int64_t unit = std::max<int64_t>(base, 1000);
+    int     k    = std::min(streak - 1, 62);
+    return unit > (cap >> k) ? cap : unit << k;
+}
+
+// 再乘以 0.8 ~ 1.2 的随机因子，同时崩溃的一批进程不会同时重启。须持有 m_mutex
+int64_t Supervisor::backoffDelay(const ProcessConfig& cfg, int streak) {
+    int64_t d = backoffBaseMs(cfg, streak);
+    if (d == 0) return 0;
+    int64_t cap = std::max(backoffBaseMs(cfg, 1), std::max(0, cfg.backoffMaxSeconds) * int64_t(1000));
+    std::uniform_real_distribution<double> jitter(0.8, 1.2);
+    return std::min(cap, (int64_t)(d * jitter(m_rng)));
+}
+
+namespace {
+
+// 按 restartOn 规则判断这次退出是否需要守护重启。未知取值由配置校验报告，这里按默认的 "always" 处理
+bool restartWanted(const ProcessConfig& cfg, uint32_t exitCode) {
+    if (cfg.restartOn == "never") return false;
+    if (cfg.restartOn == "on-failure") return exitCode != 0;
+    if (cfg.restartOn == "codes")
+        return std::find(cfg.restartCodes.begin(), cfg.restartCodes.end(), exitCode) != cfg.restartCodes.end();
+    return true;
+}
+
+} // namespace
+
+// ─── 进程退出处理 ────────────────────────────────────────────────────────────
+void Supervisor::onProcessExited(const std::string& id, uint32_t pid, uint32_t exitCode) {
+    bool shouldRestart = false;
+    bool relaunch      = false;
+    bool ruled         = false;   // 启用了守护，但退出码不在重启规则内
+    bool tripped       = false;
+    int64_t delayMs    = 0;
+    int  streak        = 0;
+    int  window        = 0;
+    size_t recent      = 0;
+    std::unique_ptr<IProcess> exited;
+    ConfigPtr snap = m_host.config();
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        if (it == m_procs.end()) return;
+
+        ManagedProcess& mp = it->second;
+        // 已被新一次启动取代的进程，其退出与当前状态无关
+        if (!mp.proc || mp.proc->pid() != pid) return;
+        exited = std::move(mp.proc);
+        mp.pid = 0;
+        relaunch = mp.restartPending;
+        mp.restartPending = false;
+        mp.status = ProcStatus::Stopped;
+
+        // 检查是否启用了进程守护，以及这次退出是否符合重启规则
+        const ProcessConfig* cit = mp.guardStopped ? nullptr : snap->find(id);
+        if (cit && cit->guardEnabled && !restartWanted(*cit, exitCode)) {
+            ruled = true;
+            mp.crashStreak = 0;
+        } else if (cit && cit->guardEnabled) {
+            auto now = std::chrono::steady_clock::now();
+            // 连续运行足够久视为已恢复，退避从头计算
+            if (now - mp.startedAt >= std::chrono::seconds(std::max(1, cit->backoffMaxSeconds)))
+                mp.crashStreak = 0;
+            // 频繁崩溃判定：只保留统计窗口内的重启时间
+            window = cit->restartWindowSeconds;
+            auto& times = mp.restartTimes;
+            if (cit->maxRestarts > 0 && window > 0) {
+                auto from = now - std::chrono::seconds(window);
+                times.erase(times.begin(), std::find_if(times.begin(), times.end(),
+                                                        [&](const auto& t) { return t >= from; }));
+            } else {
+                times.clear();
+            }
+            if (cit->maxRestarts > 0 && window > 0 && (int)times.size() >= cit->maxRestarts) {
+                tripped    = true;
+                mp.tripped = true;
+                mp.status  = ProcStatus::Failed;
+            } else {
+                if (cit->maxRestarts > 0 && window > 0) times.push_back(now);
+                shouldRestart = true;
+                streak        = ++mp.crashStreak;
+                delayMs       = backoffDelay(*cit, streak);
+                mp.backoffMs  = delayMs;
+                mp.restartAt  = now + std::chrono::milliseconds(delayMs);
+                mp.status     = ProcStatus::Restarting;
+            }
+            recent = times.size();
+        }
+    }
+    exited.reset();
+
+    if (shouldRestart && delayMs == 0) {
+        logf("[进程] %-20s  异常退出 (code=%u)，立即守护重启（连续第 %d 次）",
+             id.c_str(), (unsigned)exitCode, streak);
+    } else if (shouldRestart) {
+        logf("[进程] %-20s  异常退出 (code=%u)，%.1f 秒后守护重启（连续第 %d 次）",
+             id.c_str(), (unsigned)exitCode, delayMs / 1000.0, streak);
+    } else if (tripped) {
+        logf("[进程] %-20s  异常退出 (code=%u)，%d 秒内已守护重启 %zu 次，判定为频繁崩溃，停止守护",
+             id.c_str(), (unsigned)exitCode, window, recent);
+    } else if (ruled) {
+        logf("[进程] %-20s  已退出  exitCode=%u（不在守护重启规则内）", id.c_str(), (unsigned)exitCode);
+    } else {
+        logf("[进程] %-20s  已退出  exitCode=%u", id.c_str(), (unsigned)exitCode);
+    }
+
+    if (shouldRestart) {
+        notifyStatus(id, ProcStatus::Restarting);
+        // 通知发出后再挂定时器，保证前端先看到“重启中”；期间用户停止或重新启动则不再挂
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = m_procs.find(id);
+        if (it != m_procs.end() && it->second.status == ProcStatus::Restarting && !it->second.timer) {
+            it->second.restartAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+            it->second.timer = m_timers.schedule(std::chrono::milliseconds(delayMs), [this, id](TimerWheel::TimerId t) {
+                onTimer(id, t);
+            });
+        }
+    } else if (tripped) {
+        notifyStatus(id, ProcStatus::Failed);
+        dropDependents(id, ProcStatus::Failed);   // 等它恢复运行的条目不会再等到
+    } else {
+        notifyStatus(id, ProcStatus::Stopped);
+        if (relaunch) startProcess(id);   // 热重载后以新配置重新启动
+    }
+}
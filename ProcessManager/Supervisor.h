@@ -0,0 +1,162 @@
+// Supervisor.h  -  与平台无关的进程守护核心
+// 启动延迟、依赖顺序、崩溃守护、热重载差异等全部进程生命周期逻辑都在这里；
+// 进程操作委托给 IProcessBackend，配置、日志与线程切换委托给 ISupervisorHost
+#pragma once
+#include "ConfigTypes.h"
+#include "ProcessBackend.h"
+#include "TimerWheel.h"
+#include "LaunchPool.h"
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+// ─── 进程状态枚举 ─────────────────────────────────────────────────────────────
+enum class ProcStatus { Stopped, Starting, Running, Restarting, Failed };
+
+inline const char* statusStr(ProcStatus s) {
+    switch (s) {
+    case ProcStatus::Stopped:    return "stopped";
+    case ProcStatus::Starting:   return "starting";
+    case ProcStatus::Running:    return "running";
+    case ProcStatus::Restarting: return "restarting";
+    case ProcStatus::Failed:     return "failed";
+    }
+    return "stopped";
+}
+
+// 一次启动中进入启动队列的条目；pending 含发起方自身持有的 1 和每个等待依赖的条目各 1，
+// 归零时记录总用时
+struct LaunchBatch {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<size_t> total{ 0 };
+    std::atomic<size_t> pending{ 1 };
+    std::atomic<size_t> failed{ 0 };
+};
+
+// 单个受管进程的运行时状态
+struct ManagedProcess {
+    std::string               id;
+    std::unique_ptr<IProcess> proc;                   // 运行中时非空
+    uint32_t                  pid            = 0;     // 显示用 PID，bat 启动后更新为实际的子进程
+    bool                      guardStopped   = false; // 手动停止标志，置为 true 则不自动重启
+    bool                      restartPending = false; // 配置热重载要求重启：本次退出后立即以新配置启动
+    TimerWheel::TimerId       timer          = 0;     // 等待中的延迟启动或守护重启，到期前可取消
+    bool                      launching      = false; // 已从启动队列取出，正在创建进程
+    std::vector<std::string>  waitFor;                // 尚未运行的依赖；非空时保持“启动中”，全部运行后才排队
+    std::shared_ptr<LaunchBatch> waitBatch;           // 等待依赖期间所属的启动批次
+    // 守护重启退避：用户重新启动时清零
+    std::chrono::steady_clock::time_point startedAt;  // 最近一次创建成功的时间
+    std::chrono::steady_clock::time_point restartAt;  // 等待中的守护重启到期时间
+    std::vector<std::chrono::steady_clock::time_point> restartTimes;   // 统计窗口内的守护重启时间
+    int                       crashStreak    = 0;     // 连续守护重启次数，决定下一次的退避时长
+    int64_t                   backoffMs      = 0;     // 最近一次守护重启的退避时长
+    bool                      tripped        = false; // 频繁崩溃已停止守护
+    ProcStatus                status         = ProcStatus::Stopped;
+};
+
+// 守护重启退避状态，供界面显示
+struct RestartState {
+    int     attempt = 0;       // 连续守护重启次数
+    int64_t delayMs = 0;       // 最近一次的退避时长
+    int64_t dueInMs = 0;       // 距下一次守护重启的剩余时间，未在等待时为 0
+    int     recent  = 0;       // 统计窗口内已守护重启的次数
+    bool    tripped = false;   // 频繁崩溃已停止守护
+};
+
+SJ_FIELDS(RestartState, attempt, delayMs, dueInMs, recent, tripped)
+
+// Supervisor 对宿主程序的依赖
+class ISupervisorHost {
+public:
+    virtual ~ISupervisorHost() = default;
+
+    virtual ConfigPtr     config() = 0;       // 当前配置版本
+    virtual ValidationPtr validation() = 0;   // 最近一次配置校验结果
+    virtual std::string   checkPath(const std::string& path) = 0;   // 重新检查单个路径，空串表示通过
+    virtual void          revalidate() = 0;   // 校验结果已过期，请求完整校验
+
+    // 进程退出，在后端线程上调用。宿主可以直接调用 Supervisor::onProcessExited，
+    // 也可以先转交到自己的事件线程（Windows 版投递到 UI 线程）
+    virtual void processExited(const std::string& id, uint32_t pid, uint32_t exitCode) = 0;
+
+    // 状态变更，可能在任意线程调用
+    virtual void statusChanged(const std::string& id, ProcStatus status) = 0;
+
+    // 一行 UTF-8 日志，可能在任意线程调用
+    virtual void log(const std::string& line) = 0;
+};
+
+class Supervisor {
+public:
+    Supervisor(IProcessBackend& backend, ISupervisorHost& host);
+    ~Supervisor();
+
+    Supervisor(const Supervisor&) = delete;
+    Supervisor& operator=(const Supervisor&) = delete;
+
+    // 按配置 id 启动进程；未运行的依赖一并启动，依赖全部进入运行状态后才启动它本身。
+    // 若设有延迟则在依赖就绪后挂到时间轮上，到期后启动
+    bool startProcess(const std::string& id);
+
+    // 用户主动停止（会禁用守护重启）
+    bool stopProcess(const std::string& id);
+
+    // 最近一次配置校验未通过的条目不启动，直接标记为启动失败。
+    // 按 dependsOn 拓扑排序：没有依赖的条目立即并行启动，其余条目在依赖进入运行状态时
+    // 随即排队；循环依赖或依赖无法启动的条目标记为启动失败。全部完成后记录用时
+    void startAll();
+    void stopAll();
+
+    // 由 ISupervisorHost::processExited 转交。守护重启按 restartOn 规则判断是否重启，
+    // 连续崩溃时延迟指数增长并加随机抖动，窗口内重启次数超限则停止守护、标记为启动失败
+    void onProcessExited(const std::string& id, uint32_t pid, uint32_t exitCode);
+
+    // 连续第 streak 次守护重启的退避毫秒数，不含随机抖动
+    static int64_t backoffBaseMs(const ProcessConfig& cfg, int streak);
+
+    ProcStatus getStatus(const std::string& id);
+    uint32_t   getPid(const std::string& id);   // 进程运行时 PID，未运行返回 0
+    RestartState getRestartState(const std::string& id);
+
+    // 确保运行时表中存在所有配置项的 ManagedProcess 条目
+    void syncConfig();
+
+    // 应用 config.json 热重载的差异：停止被删除的进程、启动新增且已启用的进程，
+    // 重启启动参数有变化且正在运行的进程；其余进程不受影响。
+    // 守护与重启规则（guardEnabled、restartOn 等）不在差异中，onProcessExited 按退出时的配置判断，
+    // 修改后从下一次退出起生效；关闭守护时等待中的重启到期后取消。enabled 只决定「全部启动」
+    // 与新增条目是否自动启动，修改它不会启停正在运行的进程
+    void applyConfigDiff(const ConfigDiff& diff);
+
+private:
+    using BatchPtr = std::shared_ptr<LaunchBatch>;
+
+    size_t startGroup(const std::vector<std::string>& roots,
+                      const std::map<std::string, std::string>& skipped, const BatchPtr& batch);
+    void proceed(const std::string& id, const BatchPtr& batch);
+    void releaseDependents(const std::string& id);
+    void dropDependents(const std::string& id, ProcStatus status);
+    void enqueueLaunch(const std::string& id, const BatchPtr& batch);
+    void finishBatch(LaunchBatch& batch, bool ok);
+    int64_t backoffDelay(const ProcessConfig& cfg, int streak);
+    bool launchNow(const std::string& id);
+    void onTimer(const std::string& id, TimerWheel::TimerId timer);
+    void probeChildPid(const std::string& id, uint32_t rootPid, int attempt);
+    void notifyStatus(const std::string& id, ProcStatus s);
+    void logf(const char* fmt, ...);
+
+    IProcessBackend& m_backend;
+    ISupervisorHost& m_host;
+    std::mutex       m_mutex;   // 保护 m_procs 与 m_dependents；持有期间不调用宿主接口，也不析构 IProcess
+    std::map<std::string, ManagedProcess> m_procs;
+    std::map<std::string, std::vector<std::string>> m_dependents;   // 依赖 id → 正在等它运行的条目
+    std::mt19937     m_rng{ std::random_device{}() };   // 退避抖动，受 m_mutex 保护
+    LaunchPool       m_launcher;   // 析构函数中先停下，之后定时器到期也不会再提交启动任务
+    TimerWheel       m_timers;     // 最后构造、最先析构：定时器线程停下之后 m_procs 才失效
+};
@@ -0,0 +1,197 @@
+// TimerWheel.cpp  -  单线程分层时间轮
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(Clock::duration tick)
+    : m_tickLen(tick)
+    , m_start(Clock::now()) {
+    std::fill(std::begin(m_heads), std::end(m_heads), kNil);
+    m_thread = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel() {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+// ─── 时间换算 ────────────────────────────────────────────────────────────────
+uint64_t TimerWheel::ticksAt(Clock::time_point t, bool roundUp) const {
+    auto elapsed = (t - m_start).count();
+    if (elapsed <= 0) return 0;
+    auto len = m_tickLen.count();
+    uint64_t ticks = (uint64_t)(elapsed / len);
+    if (roundUp && elapsed % len) ++ticks;
+    return ticks;
+}
+
+// ─── 添加 / 取消 ─────────────────────────────────────────────────────────────
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Callback cb) {
+    Clock::time_point now = Clock::now();
+    // 到期时刻向上取整到 tick：不早于 delay 到期，最多晚一个 tick
+    uint64_t expire = ticksAt(now + std::max(delay, std::chrono::milliseconds(0)), true);
+
+    TimerId id;
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        // 时间轮为空时定时器线程不推进 m_tick，这里直接追到当前时刻
+        if (m_count == 0) m_tick = std::max(m_tick, ticksAt(now, false));
+
+        uint32_t n;
+        if (!m_free.empty()) {
+            n = m_free.back();
+            m_free.pop_back();
+        } else {
+            n = (uint32_t)m_nodes.size();
+            m_nodes.emplace_back();
+        }
+        Node& node = m_nodes[n];
+        node.expire = expire;
+        node.cb     = std::move(cb);
+        place(n);
+        ++m_count;
+
+        id   = ((TimerId)node.gen << 32) | n;
+        wake = expire < m_wakeAt;
+    }
+    if (wake) m_wake.notify_one();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id == 0) return false;
+    uint32_t n   = (uint32_t)id;
+    uint32_t gen = (uint32_t)(id >> 32);
+    Callback cb;   // 在锁外析构，回调捕获的对象可能较重
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (n >= m_nodes.size()) return false;
+        Node& node = m_nodes[n];
+        if (node.gen != gen || node.slot == kNil) return false;
+        unlink(n);
+        cb = std::move(node.cb);
+        release(n);
+    }
+    return true;
+}
+
+size_t TimerWheel::pending() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_count;
+}
+
+// ─── 槽位链表 ────────────────────────────────────────────────────────────────
+// 按距 m_tick 的远近选层：第 L 层每槽覆盖 64^L 个 tick，超出最高层范围的暂放最远处，下放时重新计算
+void TimerWheel::place(uint32_t n) {
+    uint64_t expire = std::max(m_nodes[n].expire, m_tick);
+    uint64_t delta  = expire - m_tick;
+    constexpr uint64_t kSpan = 1ull << (kLevels * kBits);
+    if (delta >= kSpan) {
+        expire = m_tick + kSpan - 1;
+        delta  = kSpan - 1;
+    }
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1ull << ((level + 1) * kBits))) ++level;
+    link(n, level * kSlots + ((uint32_t)(expire >> (level * kBits)) & kMask));
+}
+
+void TimerWheel::link(uint32_t n, uint32_t slot) {
+    Node& node = m_nodes[n];
+    node.slot = slot;
+    node.prev = kNil;
+    node.next = m_heads[slot];
+    if (node.next != kNil) m_nodes[node.next].prev = n;
+    m_heads[slot] = n;
+}
+
+void TimerWheel::unlink(uint32_t n) {
+    Node& node = m_nodes[n];
+    if (node.prev != kNil) m_nodes[node.prev].next = node.next;
+    else                   m_heads[node.slot]      = node.next;
+    if (node.next != kNil) m_nodes[node.next].prev = node.prev;
+    node.slot = kNil;
+}
+
+void TimerWheel::release(uint32_t n) {
+    Node& node = m_nodes[n];
+    node.cb   = nullptr;
+    node.slot = kNil;
+    if (++node.gen == 0) node.gen = 1;   // id 永不为 0
+    m_free.push_back(n);
+    --m_count;
+}
+
+// ─── 推进 ────────────────────────────────────────────────────────────────────
+// 把高层一个槽里的定时器按剩余时间重新放入低层
+void TimerWheel::cascade(int level, uint32_t index) {
+    uint32_t slot = level * kSlots + index;
+    uint32_t n = m_heads[slot];
+    m_heads[slot] = kNil;
+    while (n != kNil) {
+        uint32_t next = m_nodes[n].next;
+        m_nodes[n].slot = kNil;
+        place(n);
+        n = next;
+    }
+}
+
+// 处理 m_tick 这一格：第 0 层转满一圈时先从上层下放，再取出本格全部到期的定时器
+void TimerWheel::advance(std::vector<std::pair<TimerId, Callback>>& due) {
+    uint32_t index = (uint32_t)m_tick & kMask;
+    if (index == 0) {
+        for (int level = 1; level < kLevels; ++level) {
+            uint32_t i = (uint32_t)(m_tick >> (level * kBits)) & kMask;
+            cascade(level, i);
+            if (i != 0) break;
+        }
+    }
+    uint32_t n = m_heads[index];
+    m_heads[index] = kNil;
+    while (n != kNil) {
+        Node& node = m_nodes[n];
+        uint32_t next = node.next;
+        due.emplace_back(((TimerId)node.gen << 32) | n, std::move(node.cb));
+        release(n);
+        n = next;
+    }
+    ++m_tick;
+}
+
+// 第 0 层本圈内到下一个非空格还有几个 tick；本圈已空则睡到下一次下放。
+// m_tick 恰在圈首时它的下放还没做，不能跳过
+uint64_t TimerWheel::idleTicks() const {
+    uint32_t index = (uint32_t)m_tick & kMask;
+    if (index == 0) return 0;
+    for (uint32_t i = index; i < kSlots; ++i)
+        if (m_heads[i] != kNil) return i - index;
+    return kSlots - index;
+}
+
+void TimerWheel::run() {
+    std::vector<std::pair<TimerId, Callback>> due;
+    std::unique_lock<std::mutex> lk(m_mutex);
+    while (!m_stop) {
+        uint64_t now = ticksAt(Clock::now(), false);
+        while (m_count > 0 && m_tick <= now) advance(due);
+
+        if (!due.empty()) {
+            lk.unlock();
+            for (auto& [id, cb] : due) cb(id);
+            due.clear();
+            lk.lock();
+            continue;
+        }
+
+        if (m_count == 0) {
+            m_wakeAt = UINT64_MAX;
+            m_wake.wait(lk);
+        } else {
+            m_wakeAt = m_tick + idleTicks();
+            m_wake.wait_until(lk, m_start + m_tickLen * (Clock::rep)m_wakeAt);
+        }
+    }
+}
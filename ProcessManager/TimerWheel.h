@@ -0,0 +1,78 @@
+// TimerWheel.h  -  单线程分层时间轮
+// 延迟启动、守护重启等一次性定时任务都挂在这里，由一个线程统一到期回调，
+// 等待中的任务只占一个节点，不再各自占用一个线程
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class TimerWheel {
+public:
+    using TimerId  = uint64_t;                      // 0 表示无定时器
+    using Callback = std::function<void(TimerId)>;  // 参数为到期定时器自身的 id
+
+    // tick 即时间精度；测试可传入微秒级的 tick，在短时间内走完高层的下放
+    explicit TimerWheel(std::chrono::steady_clock::duration tick = std::chrono::milliseconds(100));
+    ~TimerWheel();   // 停止定时器线程，未到期的定时器直接丢弃
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 到期时刻向上取整到 tick（不早于 delay，最多晚一个 tick）；回调在定时器线程中执行，执行期间不持有时间轮的锁，
+    // 可以在回调中再次 schedule / cancel
+    TimerId schedule(std::chrono::milliseconds delay, Callback cb);
+
+    // 到期前取消返回 true；回调已被取出（正在或已经执行）返回 false
+    bool cancel(TimerId id);
+
+    size_t pending();
+
+private:
+    // 4 级 × 64 槽，每级覆盖上一级的 64 倍；tick = 100ms 时最长约 19 天，更远的到期时间逐级下放
+    static constexpr int      kLevels = 4;
+    static constexpr int      kBits   = 6;
+    static constexpr uint32_t kSlots  = 1u << kBits;
+    static constexpr uint32_t kMask   = kSlots - 1;
+    static constexpr uint32_t kNil    = UINT32_MAX;
+
+    // 节点存放在 m_nodes 中按下标链接，取消时 O(1) 摘链；释放后 gen 递增，旧 id 随之失效
+    struct Node {
+        uint64_t expire = 0;      // 到期 tick（绝对值）
+        uint32_t gen    = 1;
+        uint32_t slot   = kNil;   // 所在槽位 level * kSlots + index，kNil 表示空闲
+        uint32_t prev   = kNil;
+        uint32_t next   = kNil;
+        Callback cb;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t ticksAt(Clock::time_point t, bool roundUp) const;
+    void     place(uint32_t n);
+    void     link(uint32_t n, uint32_t slot);
+    void     unlink(uint32_t n);
+    void     release(uint32_t n);
+    void     cascade(int level, uint32_t index);
+    void     advance(std::vector<std::pair<TimerId, Callback>>& due);
+    uint64_t idleTicks() const;
+    void     run();
+
+    const Clock::duration   m_tickLen;
+    const Clock::time_point m_start;
+
+    std::mutex              m_mutex;            // 保护以下状态
+    std::condition_variable m_wake;
+    std::vector<Node>       m_nodes;
+    std::vector<uint32_t>   m_free;
+    uint32_t                m_heads[kLevels * kSlots];
+    uint64_t                m_tick    = 0;      // 下一个待处理的 tick
+    uint64_t                m_wakeAt  = UINT64_MAX;   // 定时器线程计划醒来的 tick
+    size_t                  m_count   = 0;
+    bool                    m_stop    = false;
+    std::thread             m_thread;
+};
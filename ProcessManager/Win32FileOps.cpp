@@ -0,0 +1,41 @@
+// Win32FileOps.cpp  -  FileOps 的 Windows 实现
+#include "FileOps.h"
+#include <windows.h>
+
+namespace fileops {
+
+static std::string withCode(const char* what, DWORD err) {
+    return std::string(what) + "  错误码=" + std::to_string(err);
+}
+
+bool writeDurable(const std::string& path, const std::string& data, std::string& error) {
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        error = withCode("无法创建临时文件", GetLastError());
+        return false;
+    }
+    DWORD written = 0;
+    BOOL ok = WriteFile(h, data.data(), (DWORD)data.size(), &written, nullptr) &&
+              written == (DWORD)data.size() &&
+              FlushFileBuffers(h);
+    DWORD err = ok ? 0 : GetLastError();
+    CloseHandle(h);
+    if (!ok) error = withCode("写入失败", err);
+    return ok != FALSE;
+}
+
+bool replace(const std::string& from, const std::string& to, std::string& error) {
+    if (MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) return true;
+    error = withCode("替换失败", GetLastError());
+    return false;
+}
+
+bool remove(const std::string& path) {
+    return DeleteFileA(path.c_str()) || GetLastError() == ERROR_FILE_NOT_FOUND;
+}
+
+bool exists(const std::string& path) {
+    return GetFileAttributesA(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+} // namespace fileops
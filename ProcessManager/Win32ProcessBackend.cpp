@@ -0,0 +1,192 @@
+// Win32ProcessBackend.cpp  -  Windows 进程后端
+#include "Win32ProcessBackend.h"
+#include <windows.h>
+#include <winbase.h>            // RegisterWaitForSingleObject、UnregisterWaitEx
+#ifndef WT_EXECUTEONCE
+#define WT_EXECUTEONCE 0x00000008
+#endif
+#include <tlhelp32.h>           // CreateToolhelp32Snapshot、PROCESSENTRY32W
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cwchar>
+
+// ─── UTF-8 编码转换辅助函数 ───────────────────────────────────────────────────
+static std::wstring utf8ToWide(const std::string& s) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+    std::wstring w(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, w.data(), len);
+    w.resize(wcslen(w.c_str()));
+    return w;
+}
+
+static std::string wideToUtf8(const wchar_t* w) {
+    int len = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+    std::string s(len, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, w, -1, s.data(), len, nullptr, nullptr);
+    s.resize(strlen(s.c_str()));
+    return s;
+}
+
+// 在退出回调中析构进程对象时不能等待回调自身结束
+static thread_local bool t_inExitCallback = false;
+
+// ─── 进程对象 ────────────────────────────────────────────────────────────────
+namespace {
+
+class Win32Process : public IProcess {
+public:
+    Win32Process(HANDLE hProcess, DWORD pid, HANDLE hJob)
+        : m_process(hProcess), m_pid(pid), m_job(hJob) {}
+
+    ~Win32Process() override {
+        if (m_wait) UnregisterWaitEx(m_wait, t_inExitCallback ? nullptr : INVALID_HANDLE_VALUE);
+        // 关闭 Job 句柄会触发 KILL_ON_JOB_CLOSE，走到这里时进程要么已退出，要么调用方有意放弃管理
+        if (m_job) CloseHandle(m_job);
+        CloseHandle(m_process);
+    }
+
+    uint32_t pid() const override { return m_pid; }
+
+    void killTree() override {
+        if (m_job) {
+            // 关闭 Job 句柄 → KILL_ON_JOB_CLOSE 触发
+            // 整个进程树（cmd.exe 及其所有子进程）被系统级联终止
+            CloseHandle(m_job);
+            m_job = nullptr;
+        }
+        // 额外对根进程发送终止信号，保证快速退出
+        TerminateProcess(m_process, 0);
+    }
+
+    void waitForExit(ExitCallback onExit) override {
+        m_onExit = std::move(onExit);
+        RegisterWaitForSingleObject(&m_wait, m_process, &Win32Process::waitCallback,
+                                    this, INFINITE, WT_EXECUTEONCE);
+    }
+
+private:
+    // 线程池等待回调（在线程池线程中执行）
+    static void CALLBACK waitCallback(PVOID param, BOOLEAN /*timedOut*/) {
+        auto* self = static_cast<Win32Process*>(param);
+        DWORD code = 0;
+        GetExitCodeProcess(self->m_process, &code);
+        // 回调可能析构 self，先把回调移到栈上
+        ExitCallback cb = std::move(self->m_onExit);
+        t_inExitCallback = true;
+        cb(code);
+        t_inExitCallback = false;
+    }
+
+    HANDLE       m_process;
+    DWORD        m_pid;
+    HANDLE       m_job;
+    HANDLE       m_wait = nullptr;
+    ExitCallback m_onExit;
+};
+
+} // namespace
+
+// ─── 启动进程 ────────────────────────────────────────────────────────────────
+std::unique_ptr<IProcess> Win32ProcessBackend::spawn(const SpawnSpec& spec, std::string& error) {
+    std::wstring wpath = utf8ToWide(spec.path);
+    std::wstring wargs = utf8ToWide(spec.args);
+    std::wstring workDir = utf8ToWide(spec.workDir);
+
+    // 构建命令行字符串
+    std::wstring cmdLine;
+    if (spec.script) {
+        // cmd /c 执行 bat 时用双引号嵌套，确保路径含空格也能正确解析
+        cmdLine = L"cmd.exe /c \"\"" + wpath + L"\"\"";
+    } else {
+        cmdLine = L"\"" + wpath + L"\"";
+    }
+    if (!wargs.empty()) cmdLine += L" " + wargs;
+
+    STARTUPINFOW si = {};
+    si.cb = sizeof(si);
+    PROCESS_INFORMATION pi = {};
+
+    // 后台进程：隐藏控制台窗口
+    DWORD createFlags = CREATE_SUSPENDED;
+    if (spec.background) {
+        createFlags |= CREATE_NO_WINDOW;
+        si.dwFlags    |= STARTF_USESHOWWINDOW;
+        si.wShowWindow = SW_HIDE;
+    }
+
+    std::vector<wchar_t> cmdBuf(cmdLine.begin(), cmdLine.end());
+    cmdBuf.push_back(L'\0');
+
+    // CREATE_SUSPENDED：先挂起进程，将其加入 Job Object 后再恢复，确保子进程也在 Job 内
+    BOOL ok = CreateProcessW(
+        nullptr, cmdBuf.data(),
+        nullptr, nullptr, FALSE,
+        createFlags, nullptr,
+        workDir.empty() ? nullptr : workDir.c_str(),  // 工作目录设为 bat/exe 所在目录
+        &si, &pi);
+
+    if (!ok) {
+        DWORD err = GetLastError();
+        // 用 FormatMessageW 把错误码转成系统描述文字，方便非开发人员阅读日志
+        wchar_t* errMsg = nullptr;
+        FormatMessageW(
+            FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+            nullptr, err, MAKELANGID(LANG_CHINESE_SIMPLIFIED, SUBLANG_CHINESE_SIMPLIFIED),
+            reinterpret_cast<LPWSTR>(&errMsg), 0, nullptr);
+        // 若简体中文消息获取失败，降级到系统默认语言
+        if (!errMsg) {
+            FormatMessageW(
+                FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                nullptr, err, 0,
+                reinterpret_cast<LPWSTR>(&errMsg), 0, nullptr);
+        }
+        // 去掉末尾的换行符
+        if (errMsg) {
+            for (wchar_t* p = errMsg + wcslen(errMsg) - 1;
+                 p >= errMsg && (*p == L'\r' || *p == L'\n'); --p) *p = L'\0';
+        }
+        error = "错误码=" + std::to_string(err) + "  原因：" + (errMsg ? wideToUtf8(errMsg) : "未知错误");
+        if (errMsg) LocalFree(errMsg);
+        return nullptr;
+    }
+
+    // 创建 Job Object，设置 KILL_ON_JOB_CLOSE
+    // 关闭 hJob 句柄时，Job 内所有进程（含 bat 启动的子进程）将被级联终止
+    HANDLE hJob = CreateJobObjectW(nullptr, nullptr);
+    if (hJob) {
+        JOBOBJECT_EXTENDED_LIMIT_INFORMATION jeli = {};
+        jeli.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+        SetInformationJobObject(hJob, JobObjectExtendedLimitInformation, &jeli, sizeof(jeli));
+        AssignProcessToJobObject(hJob, pi.hProcess);
+    }
+
+    // 加入 Job 后恢复进程运行
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+
+    return std::make_unique<Win32Process>(pi.hProcess, pi.dwProcessId, hJob);
+}
+
+// ─── 枚举子进程 ──────────────────────────────────────────────────────────────
+// 枚举系统快照，找到 pid 的直接子进程（跳过 conhost.exe 等辅助进程）
+std::vector<uint32_t> Win32ProcessBackend::listChildren(uint32_t pid) {
+    std::vector<uint32_t> children;
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snap == INVALID_HANDLE_VALUE) return children;
+
+    PROCESSENTRY32W pe = {};
+    pe.dwSize = sizeof(pe);
+    if (Process32FirstW(snap, &pe)) {
+        do {
+            if (pe.th32ParentProcessID != pid) continue;
+            if (pe.th32ProcessID == pid)       continue;
+            // 跳过 Windows 辅助进程，找真正的业务子进程
+            std::wstring name(pe.szExeFile);
+            if (name == L"conhost.exe" || name == L"WerFault.exe") continue;
+            children.push_back(pe.th32ProcessID);
+        } while (Process32NextW(snap, &pe));
+    }
+    CloseHandle(snap);
+    return children;
+}
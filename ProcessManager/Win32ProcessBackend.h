@@ -0,0 +1,11 @@
+// Win32ProcessBackend.h  -  Windows 进程后端
+#pragma once
+#include "ProcessBackend.h"
+
+// CreateProcessW 挂起启动后加入 KILL_ON_JOB_CLOSE 的 Job Object 再恢复，
+// 关闭 Job 句柄即可级联终止整个进程树；退出由线程池的 RegisterWaitForSingleObject 等待
+class Win32ProcessBackend : public IProcessBackend {
+public:
+    std::unique_ptr<IProcess> spawn(const SpawnSpec& spec, std::string& error) override;
+    std::vector<uint32_t> listChildren(uint32_t pid) override;
+};
@@ -59,12 +59,12 @@ static void showContextMenu(HWND hwnd) {
 // ─── WebView2 就绪回调（在 UI 线程中执行）─────────────────────────────────────
 static void onWebViewReady() {
     auto& ps  = ProcessService::instance();
-    auto& cfg = ConfigService::instance().config();
+    ConfigPtr cfg = ConfigService::instance().snapshot();
 
     // 页面加载完毕；前端挂载后会主动请求进程列表和配置
     // （通过 getProcessList/getConfig 消息触发，消息路由负责处理）
 
-    if (cfg.autoStartOnOpen) {
+    if (cfg->config.autoStartOnOpen) {
         ps.startAll();
     }
 }
@@ -89,8 +89,10 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
         // 添加系统托盘图标
         trayAdd(hwnd);
 
-        // 加载配置文件
+        // 加载配置文件，并监视外部对 config.json 的修改；各条目的路径在后台并行校验
         ConfigService::instance().load();
+        ConfigService::instance().startWatching(hwnd);
+        ConfigService::instance().startValidation(hwnd);
 
         // 初始化进程服务
         ProcessService::instance().setMainWindow(hwnd);
@@ -138,6 +140,32 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
         return 0;
     }
 
+    // ── config.json 被外部修改（来自 ConfigService 监视线程）────────────────
+    // 编辑器保存时往往连续写入多次，每次通知都把计时器推后，静默后才重载一次
+    case WM_APP_CONFIG_CHANGED: {
+        SetTimer(hwnd, IDT_CONFIG_RELOAD, ConfigService::kReloadDebounceMs, nullptr);
+        return 0;
+    }
+
+    // ── 配置校验完成（来自 ConfigService 校验线程）──────────────────────────
+    case WM_APP_CONFIG_VALIDATED: {
+        MessageRouter::instance().pushProcessList();
+        return 0;
+    }
+
+    case WM_TIMER: {
+        if (wParam == IDT_CONFIG_RELOAD) {
+            KillTimer(hwnd, IDT_CONFIG_RELOAD);
+            ConfigDiff diff;
+            if (ConfigService::instance().reload(diff)) {
+                ProcessService::instance().applyConfigDiff(diff);
+                MessageRouter::instance().pushProcessList();
+                MessageRouter::instance().pushConfig();
+            }
+        }
+        return 0;
+    }
+
     // ── 系统托盘消息 ──────────────────────────────────────────────────────
     case WM_TRAYICON: {
         if (lParam == WM_LBUTTONDBLCLK || lParam == WM_LBUTTONUP) {
@@ -172,6 +200,9 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
 
     case WM_DESTROY: {
         ProcessService::instance().stopAll();
+        ConfigService::instance().stopWatching();
+        ConfigService::instance().stopValidation();
+        ConfigService::instance().flush();   // 写入尚在去抖等待中的配置
         trayRemove();
         CoUninitialize();
         PostQuitMessage(0);
@@ -0,0 +1,305 @@
+// posix_main.cpp  -  Linux 无界面宿主
+// 不参与 Windows 构建。读取 config.json，用 Supervisor + PosixProcessBackend 守护其中的进程，
+// 日志写到标准输出；config.json 被改写（inotify，去抖 300ms）或收到 SIGHUP 时重新读取配置并增量应用，
+// SIGINT / SIGTERM 停止全部进程后退出。
+// 用法：pm_posix [config.json 路径，默认与程序同目录]
+#include "Supervisor.h"
+#include "PosixProcessBackend.h"
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+// 与 Windows 版相同：配置文件默认放在程序所在目录
+std::string defaultConfigPath() {
+    char buf[4096];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) return "config.json";
+    std::string exe(buf, (size_t)n);
+    auto pos = exe.rfind('/');
+    return pos == std::string::npos ? "config.json" : exe.substr(0, pos + 1) + "config.json";
+}
+
+// 与 ConfigService::kReloadDebounceMs 相同：编辑器保存一次常触发多个事件，最后一个事件后再等这么久才读取
+constexpr int kReloadDebounceMs = 300;
+
+// 监视 config.json 所在目录：编辑器常以「写临时文件再改名」的方式保存，只监视文件本身会在替换后失效。
+// 失败时返回 -1，仍可用 SIGHUP 重新加载
+int watchConfigDir(const std::string& path) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return -1;
+    auto pos = path.rfind('/');
+    std::string dir = pos == std::string::npos ? "." : pos == 0 ? "/" : path.substr(0, pos);
+    if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 读空 inotify 队列，返回其中是否有 config.json 的事件；队列溢出时保守地当作有变化
+bool drainConfigEvents(int fd, const std::string& name) {
+    alignas(inotify_event) char buf[4096];
+    bool hit = false;
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) return hit;
+        for (ssize_t off = 0; off < n;) {
+            auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+            if (ev->mask & IN_Q_OVERFLOW) hit = true;
+            else if (ev->len && name == ev->name) hit = true;
+            off += (ssize_t)(sizeof(inotify_event) + ev->len);
+        }
+    }
+}
+
+// 退出时等待全部进程结束的上限
+constexpr int kStopWaitMs = 5000;
+
+bool anyRunning(Supervisor& sup, const ConfigSnapshot& snap) {
+    for (const auto& p : snap.config.processes)
+        if (sup.getPid(p.id) != 0) return true;
+    return false;
+}
+
+// prev 为当前版本，没有 id 的条目沿用其中对应条目的 id
+bool loadConfig(const std::string& path, ConfigSnapshot& snap, const ConfigSnapshot* prev, std::string& error) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        error = "无法打开 " + path;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    try {
+        sj::decode(text, snap.config);
+    } catch (const std::exception& e) {
+        error = path + " 解析失败：" + e.what();
+        return false;
+    }
+    assignMissingIds(snap.config, prev);
+    snap.reindex();
+    return true;
+}
+
+// ─── 宿主 ────────────────────────────────────────────────────────────────────
+class PosixHost : public ISupervisorHost {
+public:
+    // 与退出回调互斥：attach(nullptr) 返回时正在执行的回调已经结束，之后的回调不再进入 Supervisor
+    void attach(Supervisor* sup) {
+        std::lock_guard<std::mutex> lock(m_supMutex);
+        m_sup = sup;
+    }
+
+    void setConfig(ConfigPtr cfg) {
+        std::atomic_store(&m_config, std::move(cfg));
+        revalidate();
+    }
+
+    ConfigPtr config() override { return std::atomic_load(&m_config); }
+
+    ValidationPtr validation() override { return std::atomic_load(&m_validation); }
+
+    // 与 ConfigService::checkPath 的措辞一致
+    std::string checkPath(const std::string& path) override {
+        if (path.empty()) return "未设置程序路径";
+        if (path.find('/') == std::string::npos) {
+            const char* env = std::getenv("PATH");
+            std::string dirs = env ? env : "/usr/bin:/bin";
+            for (size_t b = 0; b <= dirs.size();) {
+                size_t e = dirs.find(':', b);
+                if (e == std::string::npos) e = dirs.size();
+                std::string dir = e > b ? dirs.substr(b, e - b) : ".";
+                if (access((dir + "/" + path).c_str(), X_OK) == 0) return {};
+                b = e + 1;
+            }
+            return "在系统搜索路径中找不到该程序";
+        }
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            switch (errno) {
+            case ENOENT:  return access(path.substr(0, path.rfind('/') + 1).c_str(), F_OK) == 0
+                                 ? "文件不存在" : "所在目录不存在";
+            case EACCES:  return "没有访问权限";
+            default:      return std::string("无法访问（") + std::strerror(errno) + "）";
+            }
+        }
+        if (S_ISDIR(st.st_mode)) return "路径指向的是目录";
+        return {};
+    }
+
+    // 条目数量不大，同步完整检查一次
+    void revalidate() override {
+        ConfigPtr snap = config();
+        auto v = std::make_shared<ConfigValidation>();
+        std::unordered_map<std::string, size_t> counts;
+        for (const auto& p : snap->config.processes) ++counts[p.id];
+        for (const auto& p : snap->config.processes) {
+            if (counts[p.id] > 1) {
+                v->issues[p.id] = { p.path, "id 重复（共 " + std::to_string(counts[p.id]) + " 项）", true };
+                continue;
+            }
+            if (std::string rule = checkRestartRule(p); !rule.empty()) {
+                v->issues[p.id] = { p.path, std::move(rule), true };
+                continue;
+            }
+            std::string msg = checkPath(p.path);
+            if (!msg.empty()) v->issues[p.id] = { p.path, msg, false };
+        }
+        std::atomic_store(&m_validation, ValidationPtr(std::move(v)));
+    }
+
+    // 没有界面线程，直接在回收线程上转交。后端只有一个回收线程，持锁不会让回调相互等待
+    void processExited(const std::string& id, uint32_t pid, uint32_t exitCode) override {
+        std::lock_guard<std::mutex> lock(m_supMutex);
+        if (m_sup) m_sup->onProcessExited(id, pid, exitCode);
+    }
+
+    void statusChanged(const std::string&, ProcStatus) override {}
+
+    void log(const std::string& line) override {
+        std::time_t now = std::time(nullptr);
+        std::tm tm;
+        localtime_r(&now, &tm);
+        char ts[32];
+        std::strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", &tm);
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        std::fprintf(stdout, "[%s] %s\n", ts, line.c_str());
+        std::fflush(stdout);
+    }
+
+private:
+    std::mutex               m_supMutex;   // 保护 m_sup，回调期间一直持有
+    Supervisor*              m_sup = nullptr;
+    ConfigPtr                m_config     = std::make_shared<ConfigSnapshot>();
+    ValidationPtr            m_validation = std::make_shared<ConfigValidation>();
+    std::mutex               m_logMutex;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : defaultConfigPath();
+
+    auto snap = std::make_shared<ConfigSnapshot>();
+    std::string error;
+    if (!loadConfig(path, *snap, nullptr, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    // 先屏蔽再创建线程，信号只由主线程经 signalfd 接收；子进程由后端恢复默认屏蔽字
+    sigset_t sigs;
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    sigaddset(&sigs, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &sigs, nullptr);
+    int sigFd = signalfd(-1, &sigs, SFD_CLOEXEC);
+    if (sigFd < 0) {
+        std::fprintf(stderr, "signalfd 失败：%s\n", std::strerror(errno));
+        return 1;
+    }
+    const std::string fileName = path.substr(path.rfind('/') + 1);
+    int watchFd  = watchConfigDir(path);
+    int watchErr = errno;
+
+    PosixHost host;
+    host.setConfig(std::move(snap));
+    int pollErr = 0;   // poll 出错退出主循环时的 errno，此时没有收到信号
+    {
+        PosixProcessBackend backend;
+        Supervisor sup(backend, host);
+        host.attach(&sup);
+
+        host.log("[主程序] 已加载 " + path + "，共 " +
+                 std::to_string(host.config()->config.processes.size()) + " 个进程");
+        sup.syncConfig();
+        sup.startAll();
+
+        if (watchFd < 0)
+            host.log(std::string("[配置] 无法监视配置目录，仅在收到 SIGHUP 时重新加载：") + std::strerror(watchErr));
+
+        using Clock = std::chrono::steady_clock;
+        bool pending = false;           // 有未处理的文件变化，到 deadline 时重新加载
+        Clock::time_point deadline;
+        int sig = 0;
+        for (;;) {
+            pollfd fds[2] = { { sigFd, POLLIN, 0 }, { watchFd, POLLIN, 0 } };
+            int timeout = -1;
+            if (pending) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                timeout = (int)std::max<long long>(0, left);
+            }
+            int n = poll(fds, watchFd < 0 ? 1 : 2, timeout);
+            if (n < 0 && errno != EINTR) {
+                pollErr = errno;
+                break;
+            }
+
+            bool reload = false;
+            if (n > 0 && (fds[0].revents & POLLIN)) {
+                signalfd_siginfo si;
+                if (read(sigFd, &si, sizeof(si)) != (ssize_t)sizeof(si)) continue;
+                sig = (int)si.ssi_signo;
+                if (sig != SIGHUP) break;
+                reload = true;
+            }
+            if (n > 0 && watchFd >= 0 && (fds[1].revents & POLLIN) && drainConfigEvents(watchFd, fileName)) {
+                pending  = true;
+                deadline = Clock::now() + std::chrono::milliseconds(kReloadDebounceMs);
+            }
+            if (pending && Clock::now() >= deadline) reload = true;
+            if (!reload) continue;
+            pending = false;
+
+            auto next = std::make_shared<ConfigSnapshot>();
+            ConfigPtr cur = host.config();
+            ConfigDiff diff;
+            if (!loadConfig(path, *next, cur.get(), error)) {
+                host.log("[配置] 重新加载失败，保持当前配置：" + error);
+                continue;
+            }
+            if (!diffConfig(*cur, *next, diff)) continue;
+            host.setConfig(std::move(next));
+            host.log("[配置] 已重新加载  新增 " + std::to_string(diff.added.size()) +
+                     "  删除 " + std::to_string(diff.removed.size()) +
+                     "  需重启 " + std::to_string(diff.relaunch.size()));
+            sup.applyConfigDiff(diff);
+        }
+        if (pollErr)
+            host.log(std::string("[主程序] poll 失败：") + std::strerror(pollErr) +
+                     "（errno=" + std::to_string(pollErr) + "），停止全部进程");
+        else
+            host.log(std::string("[主程序] 收到 ") + (sig == SIGINT ? "SIGINT" : "SIGTERM") + "，停止全部进程");
+        sup.stopAll();
+        // stopAll 只发出终止信号：等各进程退出、退出经回调记入日志，进程不肯退出时最多等 kStopWaitMs
+        auto stopDeadline = Clock::now() + std::chrono::milliseconds(kStopWaitMs);
+        while (Clock::now() < stopDeadline && anyRunning(sup, *host.config()))
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // 之后 sup、backend 依次析构，不能再有回调进入 Supervisor
+        host.attach(nullptr);
+    }
+    if (watchFd >= 0) close(watchFd);
+    close(sigFd);
+    return pollErr ? 1 : 0;
+}
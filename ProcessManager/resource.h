@@ -10,3 +10,6 @@
 #define WM_APP_PROC_EXIT  (WM_APP + 11)
 #define WM_APP_WEBVIEW_READY (WM_APP + 12)
 #define WM_APP_STATUS_CHANGED (WM_APP + 13)
+#define WM_APP_CONFIG_CHANGED (WM_APP + 14)
+#define WM_APP_CONFIG_VALIDATED (WM_APP + 15)
+#define IDT_CONFIG_RELOAD 301
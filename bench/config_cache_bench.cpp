@@ -0,0 +1,82 @@
+// config_cache_bench.cpp  -  启动缓存与解析 config.json 的对比基准
+// 启动时两条路径都先哈希 config.json 的全文，之后：
+//   parse —— ConfigStore::parse 解析 JSON 文本（缓存缺失或失效时的路径）；
+//   cache —— ConfigStore::decodeCache 校验文件头与正文哈希并解码 MessagePack 正文。
+// 以 10、1k、10k 个条目测量，报告两种文件的大小、每次加载的耗时与加速比。
+// 用法：config_cache_bench [最大条目数，默认 10000]
+#include "ConfigStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+AppConfig makeConfig(size_t n) {
+    AppConfig cfg;
+    cfg.processes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p;
+        p.id   = newProcessId();
+        p.name = "worker-" + std::to_string(i);
+        p.path = "C:\\svc\\bin\\worker" + std::to_string(i % 50) + ".exe";
+        p.type = "exe";
+        p.args = "--port " + std::to_string(9000 + i) + " --log \"D:\\logs\\worker" + std::to_string(i) + ".log\"";
+        p.delaySeconds = (int)(i % 5);
+        p.priority     = (int)(i % 3);
+        if (i > 0 && i % 4 == 0) p.dependsOn.push_back(cfg.processes[i / 2].id);
+        cfg.processes.push_back(std::move(p));
+    }
+    return cfg;
+}
+
+volatile size_t g_sink;
+
+void benchLoad(size_t n) {
+    AppConfig cfg = makeConfig(n);
+    const std::string text  = sj::encode(cfg, true);   // 与 ConfigService 保存的格式相同
+    const std::string cache = ConfigStore::encodeCache(ConfigStore::contentHash(text), cfg);
+
+    const size_t rounds = std::max<size_t>(5, 20000 / n);
+    auto t0 = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        AppConfig out;
+        uint64_t hash = ConfigStore::contentHash(text);
+        if (!ConfigStore::parse(text, out) || hash == 0) std::abort();
+        g_sink = out.processes.size();
+    }
+    double parseMs = msSince(t0) / (double)rounds;
+
+    t0 = Clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        AppConfig out;
+        if (!ConfigStore::decodeCache(cache, ConfigStore::contentHash(text), out)) std::abort();
+        g_sink = out.processes.size();
+    }
+    double cacheMs = msSince(t0) / (double)rounds;
+
+    std::printf("%-10s %8zu %10zu %10zu %10.3f %10.3f %8.1fx\n", "load", n, text.size(), cache.size(),
+                parseMs, cacheMs, parseMs / cacheMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? (size_t)std::strtoull(argv[1], nullptr, 10) : 10000;
+
+    std::printf("%-10s %8s %10s %10s %10s %10s %9s\n",
+                "case", "entries", "json B", "cache B", "parse ms", "cache ms", "speedup");
+    for (size_t n : { (size_t)10, (size_t)1000, (size_t)10000 }) {
+        if (n > maxN) break;
+        benchLoad(n);
+    }
+    return 0;
+}
@@ -0,0 +1,259 @@
+// json_bench.cpp  -  SimpleJson 解析 / 序列化基准
+// 生成 10、1k、100k 个进程条目的 config.json 以及一组界面消息，分别测量
+//   DOM 解析（默认分配器 / Document arena / 原位）、SJ_FIELDS 结构体解码、stringify、结构体编码，
+// 以及消息路由的典型负载：sj::Lazy 取 action 后解码 process 对象、Writer 拼装状态推送。
+// 输出吞吐量 MB/s 与每个文档的堆分配次数（全局 operator new 计数），用于比较解析器改动前后的数字。
+// 用法：json_bench [最少运行毫秒数，默认 300]
+#include "SimpleJson.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// ─── 分配计数 ────────────────────────────────────────────────────────────────
+static std::atomic<size_t> g_allocs{0};
+
+void* operator new(size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void  operator delete(void* p) noexcept         { std::free(p); }
+void  operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// std::pmr::new_delete_resource 走带对齐参数的重载
+void* operator new(size_t n, std::align_val_t al) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    size_t a = (size_t)al < sizeof(void*) ? sizeof(void*) : (size_t)al;
+    void* p = nullptr;
+    if (posix_memalign(&p, a, n ? n : 1) == 0) return p;
+    throw std::bad_alloc();
+}
+void  operator delete(void* p, std::align_val_t) noexcept         { std::free(p); }
+void  operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+// 与 ConfigTypes.h 中 ProcessConfig 相同的字段表，基准不依赖 ConfigTypes.cpp
+struct BenchProcess {
+    std::string id, name, path, type, args;
+    int  delaySeconds = 0;
+    bool guardEnabled = true;
+    int  guardDelaySeconds = 1;
+    bool enabled = true;
+    bool background = false;
+    int  priority = 0;
+    std::vector<std::string> dependsOn;
+    std::string restartOn = "always";
+    std::vector<uint32_t> restartCodes;
+    int  backoffMaxSeconds = 60;
+    int  maxRestarts = 10;
+    int  restartWindowSeconds = 300;
+};
+
+SJ_FIELDS(BenchProcess, id, name, path, type, args, delaySeconds,
+          guardEnabled, guardDelaySeconds, enabled, background, priority, dependsOn,
+          restartOn, restartCodes, backoffMaxSeconds, maxRestarts, restartWindowSeconds)
+
+struct BenchConfig {
+    bool autoStartOnOpen = false;
+    int  launchConcurrency = 0;
+    std::vector<BenchProcess> processes;
+};
+
+SJ_FIELDS(BenchConfig, autoStartOnOpen, launchConcurrency, processes)
+
+BenchProcess makeProcess(size_t i) {
+    char id[40];
+    std::snprintf(id, sizeof(id), "%08zx-1a2b-4c3d-8e4f-%012zx", i * 2654435761u, i);
+    BenchProcess p;
+    p.id   = id;
+    p.name = "服务 " + std::to_string(i);
+    p.path = "C:\\Program Files\\Vendor\\bin\\worker" + std::to_string(i % 37) + ".exe";
+    p.type = i % 5 == 0 ? "bat" : "exe";
+    p.args = "--port " + std::to_string(8000 + i % 1000) + " --log \"D:\\logs\\w.log\"";
+    p.delaySeconds = (int)(i % 4);
+    p.guardDelaySeconds = 1 + (int)(i % 3);
+    p.enabled = i % 11 != 0;
+    p.background = i % 2 == 0;
+    p.priority = (int)(i % 7) - 3;
+    if (i > 0 && i % 3 == 0) p.dependsOn.push_back("dep-" + std::to_string(i - 1));
+    if (i % 9 == 0) { p.restartOn = "codes"; p.restartCodes = { 1, 2, 0xC0000005u }; }
+    return p;
+}
+
+std::string makeConfig(size_t n) {
+    BenchConfig cfg;
+    cfg.processes.reserve(n);
+    for (size_t i = 0; i < n; ++i) cfg.processes.push_back(makeProcess(i));
+    return sj::encode(cfg, true);
+}
+
+// 界面发来的请求：启停、获取列表、修改进程按 8:1:1 混合
+std::vector<std::string> makeMessages(size_t n) {
+    std::vector<std::string> out;
+    out.reserve(n);
+    std::string buf;
+    for (size_t i = 0; i < n; ++i) {
+        buf.clear();
+        sj::Writer w(buf);
+        BenchProcess p = makeProcess(i);
+        switch (i % 10) {
+        case 0:
+            w.startObject().key("action").value("updateProcess").key("process");
+            sj::encode(w, p);
+            w.endObject();
+            break;
+        case 1:
+            w.startObject().key("action").value("getProcessList").endObject();
+            break;
+        default:
+            w.startObject().key("action").value(i % 2 ? "startProcess" : "stopProcess")
+             .key("id").value(p.id).endObject();
+            break;
+        }
+        out.push_back(buf);
+    }
+    return out;
+}
+
+struct Result {
+    double mbps;
+    double allocsPerDoc;
+    double usPerDoc;
+};
+
+// 重复执行 fn 直到累计 minMs，返回吞吐量与每次调用的平均分配次数
+template <class F>
+Result measure(size_t bytes, int minMs, F&& fn) {
+    fn();   // 预热
+    size_t iters = 0;
+    size_t allocs0 = g_allocs.load();
+    auto t0 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        fn();
+        ++iters;
+        elapsed = std::chrono::steady_clock::now() - t0;
+    } while (elapsed.count() * 1000 < minMs);
+    size_t allocs = g_allocs.load() - allocs0;
+    double sec = elapsed.count();
+    return { (double)bytes * iters / sec / (1024 * 1024), (double)allocs / iters, sec * 1e6 / iters };
+}
+
+void report(const char* name, size_t entries, size_t bytes, const Result& r) {
+    std::printf("%-22s %8zu %12zu %10.1f %14.1f %12.1f\n", name, entries, bytes, r.mbps, r.allocsPerDoc, r.usPerDoc);
+}
+
+// 防止结果被优化掉
+volatile size_t g_sink;
+
+void benchConfig(size_t n, int minMs) {
+    const std::string text = makeConfig(n);
+    const size_t bytes = text.size();
+
+    report("parse", n, bytes, measure(bytes, minMs, [&] {
+        sj::Value v = sj::parse(text);
+        g_sink = v["processes"].get_array().size();
+    }));
+    report("parse Document", n, bytes, measure(bytes, minMs, [&] {
+        sj::Document doc(bytes * 2);
+        g_sink = doc.parse(text)["processes"].get_array().size();
+    }));
+    report("parse_insitu Document", n, bytes, measure(bytes, minMs, [&] {
+        sj::Document doc(bytes);
+        g_sink = doc.parse_insitu(text)["processes"].get_array().size();
+    }));
+    report("decode struct", n, bytes, measure(bytes, minMs, [&] {
+        BenchConfig cfg;
+        sj::decode(text, cfg);
+        g_sink = cfg.processes.size();
+    }));
+
+    const sj::Value tree = sj::parse(text);
+    std::string out;
+    out.reserve(bytes + bytes / 4);
+    report("stringify", n, bytes, measure(bytes, minMs, [&] {
+        out.clear();
+        sj::Writer(out, true).value(tree);
+        g_sink = out.size();
+    }));
+
+    BenchConfig cfg;
+    sj::decode(text, cfg);
+    report("encode struct", n, bytes, measure(bytes, minMs, [&] {
+        out.clear();
+        sj::Writer w(out, true);
+        sj::encode(w, cfg);
+        g_sink = out.size();
+    }));
+}
+
+void benchMessages(int minMs) {
+    const size_t n = 10000;
+    const std::vector<std::string> msgs = makeMessages(n);
+    size_t bytes = 0;
+    for (const auto& m : msgs) bytes += m.size();
+
+    // 与 MessageRouter::handleMessage 相同的路径：Lazy 定位 action，仅 updateProcess 解码 process
+    Result r = measure(bytes, minMs, [&] {
+        size_t hits = 0;
+        for (const auto& m : msgs) {
+            sj::Lazy msg = sj::Lazy::parse(m);
+            std::string action = msg["action"].get_string_or("");
+            if (action == "updateProcess") {
+                BenchProcess p;
+                sj::decode(msg["process"].raw_or("{}"), p);
+                hits += p.id.size();
+            } else {
+                hits += msg["id"].get_string_or("").size();
+            }
+        }
+        g_sink = hits;
+    });
+    r.allocsPerDoc /= n;
+    r.usPerDoc /= n;
+    report("router inbound", n, bytes, r);
+
+    // processStatusChanged 推送：缓冲区跨消息复用
+    std::string buf;
+    size_t outBytes = 0;
+    Result w = measure(0, minMs, [&] {
+        outBytes = 0;
+        for (size_t i = 0; i < n; ++i) {
+            buf.clear();
+            sj::Writer wr(buf);
+            wr.startObject()
+              .key("type").value("processStatusChanged")
+              .key("id").value("0000abcd-1a2b-4c3d-8e4f-000000001234")
+              .key("status").value(i % 3 ? "running" : "restarting")
+              .key("pid").value((unsigned)(1000 + i))
+              .key("backoff").startObject()
+                .key("attempt").value((int)(i % 5)).key("delayMs").value(2000)
+                .key("dueInMs").value(0).key("recent").value(1).key("tripped").value(false)
+              .endObject()
+              .endObject();
+            outBytes += buf.size();
+        }
+        g_sink = outBytes;
+    });
+    w.mbps = w.usPerDoc > 0 ? (double)outBytes / (w.usPerDoc / 1e6) / (1024 * 1024) : 0;
+    w.allocsPerDoc /= n;
+    w.usPerDoc /= n;
+    report("router outbound", n, outBytes, w);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int minMs = argc > 1 ? std::atoi(argv[1]) : 300;
+    if (minMs <= 0) minMs = 1;
+    std::printf("%-22s %8s %12s %10s %14s %12s\n", "case", "entries", "bytes", "MB/s", "allocs/doc", "us/doc");
+    for (size_t n : { (size_t)10, (size_t)1000, (size_t)100000 }) benchConfig(n, minMs);
+    benchMessages(minMs);
+    return 0;
+}
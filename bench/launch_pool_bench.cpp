@@ -0,0 +1,111 @@
+// launch_pool_bench.cpp  -  LaunchPool 吞吐量与并发上限基准
+//   空任务：10 万个任务在并发上限 1、4、16 下的总耗时与每个任务的调度开销；
+//   模拟创建耗时：320 个各阻塞 2 ms 的任务在上限 1、4、16、64 下的总耗时，与理想值 320 × 2 ms ÷ 上限
+//                 对比，并记录实际同时执行的最大任务数（不应超过上限）；
+//   startAll：300 个条目经 Supervisor 启动，FakeProcessBackend 每次创建阻塞 2 ms，
+//             报告 startAll 返回与全部进入运行状态的耗时。
+// 用法：launch_pool_bench
+#include "FakeBackend.h"
+#include "LaunchPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// 提交 n 个任务并等待全部完成，返回总毫秒数；peak 为同时执行的最大任务数
+double runTasks(unsigned limit, size_t n, milliseconds cost, int& peak) {
+    LaunchPool pool(limit);
+    std::atomic<size_t> done{ 0 };
+    std::atomic<int> active{ 0 };
+    std::atomic<int> most{ 0 };
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        pool.submit((int)(i % 3), [&] {
+            int now = ++active;
+            for (int m = most; now > m && !most.compare_exchange_weak(m, now);) {}
+            if (cost.count()) std::this_thread::sleep_for(cost);
+            --active;
+            ++done;
+        });
+    }
+    test::waitFor([&] { return done == n; }, std::chrono::minutes(2));
+    double ms = msSince(t0);
+    peak = most;
+    return ms;
+}
+
+void benchOverhead(unsigned limit) {
+    const size_t n = 100000;
+    int peak = 0;
+    double ms = runTasks(limit, n, milliseconds(0), peak);
+    std::printf("%-10s %6u %8zu %12.1f %12.2f\n", "empty", limit, n, ms, ms * 1000 / n);
+}
+
+void benchBlocking(unsigned limit) {
+    const size_t n = 320;
+    const milliseconds cost(2);
+    int peak = 0;
+    double ms = runTasks(limit, n, cost, peak);
+    double ideal = (double)n * cost.count() / limit;
+    std::printf("%-10s %6u %8zu %12.1f %12.1f %8d\n", "2 ms", limit, n, ms, ideal, peak);
+}
+
+void benchStartAll(int limit) {
+    const size_t n = 300;
+    test::FakeProcessBackend backend;
+    backend.exitOnSpawn = [](const SpawnSpec&) {
+        std::this_thread::sleep_for(milliseconds(2));
+        return -1;
+    };
+    test::FakeHost host;
+    host.keepLog = false;
+    std::atomic<size_t> running{ 0 };
+    host.onStatus = [&](const std::string&, ProcStatus s) {
+        if (s == ProcStatus::Running) ++running;
+    };
+    std::vector<ProcessConfig> procs;
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p = test::fakeProcess("p" + std::to_string(i));
+        p.priority = (int)(i % 3);
+        procs.push_back(std::move(p));
+    }
+    host.setConfig(std::move(procs), limit);
+
+    Supervisor sup(backend, host);
+    host.sup = &sup;
+    sup.syncConfig();
+    auto t0 = Clock::now();
+    sup.startAll();
+    double returned = msSince(t0);
+    test::waitFor([&] { return running == n; }, std::chrono::minutes(2));
+    double allRunning = msSince(t0);
+    std::printf("%-10s %6d %8zu %12.2f %12.1f\n", "startAll", limit, n, returned, allRunning);
+    sup.stopAll();
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-10s %6s %8s %12s %12s\n", "case", "limit", "tasks", "total ms", "us/task");
+    for (unsigned limit : { 1u, 4u, 16u }) benchOverhead(limit);
+
+    std::printf("\n%-10s %6s %8s %12s %12s %8s\n", "case", "limit", "tasks", "total ms", "ideal ms", "peak");
+    for (unsigned limit : { 1u, 4u, 16u, 64u }) benchBlocking(limit);
+
+    std::printf("\n%-10s %6s %8s %12s %12s\n", "case", "limit", "entries", "return ms", "running ms");
+    for (int limit : { 1, 4, 16 }) benchStartAll(limit);
+    return 0;
+}
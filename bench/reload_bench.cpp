@@ -0,0 +1,102 @@
+// reload_bench.cpp  -  热重载的规模基准
+// 模拟外部改写 config.json 中的一个条目后重新加载：解析新文本（sj::decode）、沿用旧版本的 id
+// （assignMissingIds）、重建 id 索引（reindex）、与当前版本比较（diffConfig），分别报告各步与合计的耗时。
+// 以 10、1k、10k 个条目测量，文件中的条目分为全部写有 id 与全部没有 id（id 靠 name、path 与旧版本对应）两种。
+// 用法：reload_bench [最大条目数，默认 10000]
+#include "ConfigTypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+AppConfig makeConfig(size_t n, bool withIds) {
+    AppConfig cfg;
+    cfg.processes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p;
+        if (withIds) p.id = newProcessId();
+        p.name = "worker-" + std::to_string(i);
+        p.path = "/opt/svc/bin/worker" + std::to_string(i % 50);
+        p.type = "exe";
+        p.args = "--port " + std::to_string(9000 + i) + " --log /var/log/worker" + std::to_string(i) + ".log";
+        p.delaySeconds = (int)(i % 5);
+        p.priority     = (int)(i % 3);
+        if (i > 0 && withIds && i % 4 == 0) p.dependsOn.push_back(cfg.processes[i / 2].id);
+        cfg.processes.push_back(std::move(p));
+    }
+    return cfg;
+}
+
+// 与 ConfigService::reload 相同的步骤，prev 为当前版本
+ConfigPtr loadSnapshot(const std::string& text, const ConfigSnapshot* prev) {
+    auto snap = std::make_shared<ConfigSnapshot>();
+    sj::decode(text, snap->config);
+    assignMissingIds(snap->config, prev);
+    snap->reindex();
+    return snap;
+}
+
+void benchReload(size_t n, bool withIds) {
+    AppConfig cfg = makeConfig(n, withIds);
+    const std::string before = sj::encode(cfg, true);
+    cfg.processes[n / 2].args += " --verbose";   // 修改一个条目的参数，运行中的需重启
+    const std::string after = sj::encode(cfg, true);
+
+    ConfigPtr cur = loadSnapshot(before, nullptr);
+
+    // 重复次数按条目数减少，每个规模总时长相近
+    const size_t rounds = std::max<size_t>(5, 20000 / n);
+    double decodeMs = 0, idsMs = 0, indexMs = 0, diffMs = 0;
+    size_t changed = 0;
+    for (size_t r = 0; r < rounds; ++r) {
+        auto next = std::make_shared<ConfigSnapshot>();
+        auto t0 = Clock::now();
+        sj::decode(after, next->config);
+        decodeMs += msSince(t0);
+
+        t0 = Clock::now();
+        assignMissingIds(next->config, cur.get());
+        idsMs += msSince(t0);
+
+        t0 = Clock::now();
+        next->reindex();
+        indexMs += msSince(t0);
+
+        ConfigDiff diff;
+        t0 = Clock::now();
+        diffConfig(*cur, *next, diff);
+        diffMs += msSince(t0);
+        changed = diff.relaunch.size() + diff.added.size() + diff.removed.size();
+    }
+    double k = 1.0 / (double)rounds;
+    std::printf("%-10s %8zu %10.3f %10.3f %10.3f %10.3f %10.3f %8zu\n", withIds ? "ids" : "no-ids", n,
+                decodeMs * k, idsMs * k, indexMs * k, diffMs * k,
+                (decodeMs + idsMs + indexMs + diffMs) * k, changed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? (size_t)std::strtoull(argv[1], nullptr, 10) : 10000;
+
+    // 各列为每步平均毫秒数；changed 为 diff 中新增、删除与需重启的条目数，应为 1
+    std::printf("%-10s %8s %10s %10s %10s %10s %10s %8s\n",
+                "case", "entries", "decode", "ids", "reindex", "diff", "total ms", "changed");
+    for (size_t n : { (size_t)10, (size_t)1000, (size_t)10000 }) {
+        if (n > maxN) break;
+        benchReload(n, true);
+        benchReload(n, false);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// startall_bench.cpp  -  按 id 索引查找与「全部启动」的规模基准
+// 进程由 tests/FakeBackend.h 模拟，创建与回收不涉及系统调用，测到的是 Supervisor 自身的开销。
+// 分别以 10、1k、10k 个条目测量：
+//   按 id 查找：ConfigSnapshot::find（哈希索引）与逐项比较的线性查找，每次查找的耗时；
+//   startAll：无依赖与按二叉树依赖（条目 i 依赖 (i-1)/2）两种配置下，调用返回的耗时、
+//             全部进入运行状态的耗时，以及 stopAll 后全部停止的耗时。
+// 用法：startall_bench [最大条目数，默认 10000]
+#include "FakeBackend.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using test::FakeHost;
+using test::FakeProcessBackend;
+using test::fakeProcess;
+using test::waitFor;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+std::vector<ProcessConfig> makeProcesses(size_t n, bool tree) {
+    std::vector<ProcessConfig> procs;
+    procs.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p = fakeProcess("p" + std::to_string(i));
+        if (tree && i > 0) p.dependsOn.push_back("p" + std::to_string((i - 1) / 2));
+        procs.push_back(std::move(p));
+    }
+    return procs;
+}
+
+volatile size_t g_sink;
+
+void benchLookup(size_t n) {
+    auto snap = std::make_shared<ConfigSnapshot>();
+    snap->config.processes = makeProcesses(n, false);
+    snap->reindex();
+    const auto& procs = snap->config.processes;
+
+    // 查找次数与条目数无关，线性查找按条目数减少次数以控制总时长
+    const size_t hashed = 200000;
+    const size_t linear = std::max<size_t>(100, 2000000 / n);
+
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < hashed; ++i) g_sink = (size_t)snap->find(procs[i * 7919 % n].id);
+    double indexNs = msSince(t0) * 1e6 / hashed;
+
+    t0 = Clock::now();
+    for (size_t i = 0; i < linear; ++i) {
+        const std::string& id = procs[i * 7919 % n].id;
+        g_sink = (size_t)&*std::find_if(procs.begin(), procs.end(),
+                                        [&](const ProcessConfig& p) { return p.id == id; });
+    }
+    double scanNs = msSince(t0) * 1e6 / linear;
+
+    std::printf("%-10s %8zu %14.0f %14.0f\n", "lookup", n, indexNs, scanNs);
+}
+
+void benchStartAll(size_t n, bool tree) {
+    FakeProcessBackend backend;
+    FakeHost host;
+    host.keepLog = false;
+    std::atomic<size_t> running{ 0 }, stopped{ 0 };
+    host.onStatus = [&](const std::string&, ProcStatus s) {
+        if (s == ProcStatus::Running) ++running;
+        else if (s == ProcStatus::Stopped) ++stopped;
+    };
+    host.setConfig(makeProcesses(n, tree));
+
+    Supervisor sup(backend, host);
+    host.sup = &sup;
+    sup.syncConfig();
+
+    auto t0 = Clock::now();
+    sup.startAll();
+    double returned = msSince(t0);
+    bool ok = waitFor([&] { return running == n; }, std::chrono::minutes(2));
+    double allRunning = msSince(t0);
+
+    t0 = Clock::now();
+    sup.stopAll();
+    ok = waitFor([&] { return stopped == n; }, std::chrono::minutes(2)) && ok;
+    double allStopped = msSince(t0);
+
+    std::printf("%-10s %8zu %14.2f %14.2f %14.2f%s\n", tree ? "tree" : "flat", n,
+                returned, allRunning, allStopped, ok ? "" : "  (timeout)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxN = argc > 1 ? (size_t)std::atoll(argv[1]) : 10000;
+    if (maxN < 10) maxN = 10;
+    std::vector<size_t> sizes;
+    for (size_t n : { (size_t)10, (size_t)1000, (size_t)10000, (size_t)100000 })
+        if (n <= maxN) sizes.push_back(n);
+
+    std::printf("%-10s %8s %14s %14s\n", "case", "entries", "index ns", "scan ns");
+    for (size_t n : sizes) benchLookup(n);
+
+    std::printf("\n%-10s %8s %14s %14s %14s\n", "startAll", "entries", "return ms", "running ms", "stopAll ms");
+    for (bool tree : { false, true })
+        for (size_t n : sizes) benchStartAll(n, tree);
+    return 0;
+}
@@ -0,0 +1,144 @@
+// timer_bench.cpp  -  TimerWheel 的线程数、内存与到期精度基准
+// 每个规模在单独 fork 出的子进程中运行，常驻内存互不影响：
+//   挂起 0、1k、10k、100k 个 1~60 分钟后到期的定时器，报告线程数（/proc/self/status 的 Threads）、
+//   常驻内存 VmRSS 及其相对创建时间轮之前的增量，以及全部 schedule 与全部 cancel 的耗时；
+//   10k 个 0.1~2 秒内到期的定时器，报告回调相对预定时间的平均与最大延迟；
+//   300 个守护中的进程持续启动即崩溃（FakeProcessBackend），3 秒内采样到的最大线程数。
+// 用法：timer_bench
+#include "FakeBackend.h"
+#include "TimerWheel.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// /proc/self/status 中的一个数值字段（VmRSS 的单位为 kB）
+long procStatus(const char* key) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    size_t len = std::char_traits<char>::length(key);
+    while (std::getline(in, line))
+        if (line.compare(0, len, key) == 0 && line.size() > len && line[len] == ':')
+            return std::atol(line.c_str() + len + 1);
+    return -1;
+}
+
+// 在子进程中执行 fn，等它结束
+template <class F>
+void isolated(F&& fn) {
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+void benchPending(size_t n) {
+    long rss0 = procStatus("VmRSS");
+    TimerWheel wheel;
+    std::vector<TimerWheel::TimerId> ids;
+    ids.reserve(n);
+
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i)
+        ids.push_back(wheel.schedule(milliseconds(60000 + (int64_t)(i * 7919 % 3540000)), [](TimerWheel::TimerId) {}));
+    double scheduleMs = msSince(t0);
+
+    long threads = procStatus("Threads");
+    long rss = procStatus("VmRSS");
+
+    t0 = Clock::now();
+    size_t cancelled = 0;
+    for (auto id : ids) cancelled += wheel.cancel(id);
+    double cancelMs = msSince(t0);
+
+    std::printf("%-10s %8zu %8ld %10.1f %10.1f %12.2f %10.2f%s\n", "pending", n, threads,
+                rss / 1024.0, (rss - rss0) / 1024.0, scheduleMs, cancelMs,
+                cancelled == n ? "" : "  (cancel failed)");
+}
+
+void benchLateness(size_t n) {
+    TimerWheel wheel;
+    std::mutex m;
+    double sum = 0, worst = 0;
+    std::atomic<size_t> fired{ 0 };
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        auto delay = milliseconds(100 + (int64_t)(i * 7919 % 1900));
+        auto due = t0 + delay;
+        wheel.schedule(delay, [&, due](TimerWheel::TimerId) {
+            double late = msSince(due);
+            std::lock_guard<std::mutex> lock(m);
+            sum += late;
+            worst = std::max(worst, late);
+            ++fired;
+        });
+    }
+    test::waitFor([&] { return fired == n; }, milliseconds(10000));
+    std::lock_guard<std::mutex> lock(m);
+    std::printf("%-10s %8zu  fired %zu  late avg %.1f ms  max %.1f ms\n", "lateness", n,
+                fired.load(), fired ? sum / fired : 0.0, worst);
+}
+
+void benchCrashLoop(size_t n) {
+    test::FakeProcessBackend backend;
+    backend.exitOnSpawn = [](const SpawnSpec&) { return 1; };
+    test::FakeHost host;
+    host.keepLog = false;
+    std::vector<ProcessConfig> procs;
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p = test::fakeProcess("p" + std::to_string(i));
+        p.guardEnabled = true;
+        p.guardDelaySeconds = 0;
+        p.maxRestarts = 0;
+        procs.push_back(std::move(p));
+    }
+    host.setConfig(std::move(procs));
+
+    Supervisor sup(backend, host);
+    host.sup = &sup;
+    sup.syncConfig();
+    sup.startAll();
+    long peak = 0;
+    auto t0 = Clock::now();
+    while (msSince(t0) < 3000) {
+        peak = std::max(peak, procStatus("Threads"));
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    sup.stopAll();
+    std::printf("%-10s %8zu  spawned %zu in 3 s  peak threads %ld\n", "crashloop", n, backend.spawned(), peak);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-10s %8s %8s %10s %10s %12s %10s\n", "case", "timers", "threads", "RSS MB", "+RSS MB",
+                "schedule ms", "cancel ms");
+    for (size_t n : { (size_t)0, (size_t)1000, (size_t)10000, (size_t)100000 })
+        isolated([n] { benchPending(n); });
+    std::printf("\n");
+    isolated([] { benchLateness(10000); });
+    isolated([] { benchCrashLoop(300); });
+    return 0;
+}
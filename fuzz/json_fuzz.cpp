@@ -0,0 +1,142 @@
+// json_fuzz.cpp  -  SimpleJson / SimpleMsgPack 模糊测试入口
+// 同一份输入依次交给 DOM 解析（默认分配器、Document、原位）、分块流式 Reader、sj::Lazy、
+// SJ_FIELDS 结构体解码与 MessagePack 解码。格式错误只允许以 std::runtime_error 报告；
+// 解析成功的文本须满足往返不变量：紧凑输出再解析后输出相同，经 MessagePack 编解码后输出也相同。
+//   libFuzzer：clang++ -fsanitize=fuzzer,address 编译，定义 SJ_FUZZ_LIBFUZZER
+//   AFL / 重放：不定义 SJ_FUZZ_LIBFUZZER，main 依次读取参数中的文件，无参数时读取 stdin
+#include "SimpleJson.hpp"
+#include "SimpleMsgPack.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct FuzzItem {
+    std::string              id;
+    int                      n = 0;
+    int64_t                  big = 0;
+    unsigned                 u = 0;
+    bool                     on = false;
+    double                   d = 0;
+    std::vector<std::string> tags;
+    std::vector<uint32_t>    codes;
+};
+
+SJ_FIELDS(FuzzItem, id, n, big, u, on, d, tags, codes)
+
+struct FuzzDoc {
+    std::string           name;
+    std::vector<FuzzItem> items;
+    FuzzItem              head;
+};
+
+SJ_FIELDS(FuzzDoc, name, items, head)
+
+void check(bool ok, const char* what) {
+    if (ok) return;
+    std::fprintf(stderr, "invariant violated: %s\n", what);
+    std::abort();
+}
+
+std::string compact(const sj::Value& v) {
+    std::string out;
+    sj::write(out, v);
+    return out;
+}
+
+void fuzzJson(std::string_view text) {
+    std::string once;
+    try {
+        once = compact(sj::parse(std::string(text)));
+    } catch (const std::runtime_error&) {
+        once.clear();
+    }
+
+    if (!once.empty()) {
+        // 输出须能被自身重新解析，且再次输出结果一致
+        check(compact(sj::parse(once)) == once, "stringify(parse(stringify(v))) == stringify(v)");
+
+        // 原位与 arena 解析结果与默认路径一致
+        sj::Document doc;
+        check(compact(doc.parse(text)) == once, "Document::parse");
+        sj::Document insitu;
+        check(compact(insitu.parse_insitu(text)) == once, "Document::parse_insitu");
+
+        // MessagePack 往返
+        sj::Value v = sj::parse(once);
+        std::string bin = sj::msgpack::encode(v);
+        check(compact(sj::msgpack::decode(bin)) == once, "msgpack round trip");
+    }
+
+    // 流式 Reader：逐字节补充缓冲区，覆盖跨块的字符串与数字。
+    // Parser 允许值之后的多余内容而 Reader 不允许，因此只检查 Reader 接受的输入 Parser 也接受
+    try {
+        std::istringstream in{ std::string(text) };
+        sj::Reader r(in, 1);
+        for (sj::Event e = r.next(); e != sj::Event::End; e = r.next()) {}
+        check(!once.empty(), "Reader accepted input rejected by Parser");
+    } catch (const std::runtime_error&) {}
+
+    try {
+        sj::Lazy lazy = sj::Lazy::parse(text);
+        (void)lazy["name"].get_string_or("");
+        (void)lazy["items"][0]["n"].get_int64_or(0);
+        (void)lazy[size_t(0)].raw();
+    } catch (const std::runtime_error&) {}
+
+    try {
+        FuzzDoc d;
+        sj::decode(text, d);
+    } catch (const std::runtime_error&) {}
+}
+
+void fuzzMsgPack(std::string_view bytes) {
+    try {
+        sj::Value v = sj::msgpack::decode(bytes);
+        std::string once = compact(v);
+        check(compact(sj::msgpack::decode(sj::msgpack::encode(v))) == once, "msgpack re-encode");
+    } catch (const std::runtime_error&) {}
+    try {
+        FuzzDoc d;
+        sj::msgpack::decode(bytes, d);
+    } catch (const std::runtime_error&) {}
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string_view input(reinterpret_cast<const char*>(data), size);
+    fuzzJson(input);
+    fuzzMsgPack(input);
+    return 0;
+}
+
+#ifndef SJ_FUZZ_LIBFUZZER
+int main(int argc, char** argv) {
+    auto run = [](std::istream& in) {
+        std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+    };
+    if (argc < 2) {
+        run(std::cin);
+        return 0;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        run(in);
+    }
+    return 0;
+}
+#endif
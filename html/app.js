@@ -65,6 +65,9 @@ const App = {
         </el-table-column>
         <el-table-column prop="path" label="路径" min-width="220" show-overflow-tooltip>
           <template #default="{ row }">
+            <el-tooltip v-if="row.issue" :content="row.issue" placement="top">
+              <el-icon class="path-issue"><warning-filled></warning-filled></el-icon>
+            </el-tooltip>
             <el-tooltip :content="row.path" placement="top" :show-after="600">
               <span class="proc-path">{{ row.path }}</span>
             </el-tooltip>
@@ -103,10 +106,12 @@ const App = {
         </el-table-column>
         <el-table-column label="状态" width="110" align="center">
           <template #default="{ row }">
-            <el-tag :type="statusType(row.status)" size="small" effect="light" class="status-tag">
-              <span :class="['status-dot-sm', 'status-dot--' + row.status]"></span>
-              {{ statusLabel(row.status) }}
-            </el-tag>
+            <el-tooltip :content="backoffTip(row)" :disabled="!backoffTip(row)" placement="top">
+              <el-tag :type="statusType(row.status)" size="small" effect="light" class="status-tag">
+                <span :class="['status-dot-sm', 'status-dot--' + row.status]"></span>
+                {{ statusLabel(row.status) }}
+              </el-tag>
+            </el-tooltip>
           </template>
         </el-table-column>
         <el-table-column label="PID" width="90" align="center">
@@ -175,6 +180,21 @@ const App = {
           </el-input-number>
           <span class="unit-label">秒（0 = 立即启动）</span>
         </el-form-item>
+        <el-form-item label="启动优先级">
+          <el-input-number v-model="form.priority" :min="-100" :max="100"
+                           :step="1" controls-position="right">
+          </el-input-number>
+          <span class="unit-label">数值大的先启动</span>
+        </el-form-item>
+        <el-form-item label="依赖进程">
+          <el-select v-model="form.dependsOn" multiple clearable filterable
+                     placeholder="无（可选）" style="width:100%;">
+            <el-option v-for="p in dependencyOptions" :key="p.id"
+                       :label="p.name || p.path" :value="p.id">
+            </el-option>
+          </el-select>
+          <div class="setting-hint" style="margin-top:4px;">所选进程全部运行后才启动本进程；启动本进程时会先拉起未运行的依赖</div>
+        </el-form-item>
         <el-form-item label="进程守护">
           <el-switch v-model="form.guardEnabled" active-text="启用" inactive-text="关闭"></el-switch>
         </el-form-item>
@@ -184,6 +204,32 @@ const App = {
           </el-input-number>
           <span class="unit-label">秒后重启</span>
         </el-form-item>
+        <el-form-item v-if="form.guardEnabled" label="重启条件">
+          <el-select v-model="form.restartOn" style="width:160px;">
+            <el-option label="任何退出" value="always"></el-option>
+            <el-option label="退出码非 0" value="on-failure"></el-option>
+            <el-option label="指定退出码" value="codes"></el-option>
+          </el-select>
+          <el-input v-if="form.restartOn === 'codes'" v-model="form.restartCodesText"
+                    placeholder="如 1, 3, 0xC0000005" style="width:200px; margin-left:8px;">
+          </el-input>
+        </el-form-item>
+        <el-form-item v-if="form.guardEnabled" label="最长退避">
+          <el-input-number v-model="form.backoffMaxSeconds" :min="0" :max="3600"
+                           :step="10" controls-position="right">
+          </el-input-number>
+          <span class="unit-label">秒（连续崩溃时重启延迟逐次翻倍）</span>
+        </el-form-item>
+        <el-form-item v-if="form.guardEnabled" label="崩溃熔断">
+          <el-input-number v-model="form.restartWindowSeconds" :min="0" :max="86400"
+                           :step="60" controls-position="right" style="width:110px;">
+          </el-input-number>
+          <span class="unit-label">秒内最多重启</span>
+          <el-input-number v-model="form.maxRestarts" :min="0" :max="1000"
+                           :step="1" controls-position="right" style="width:100px; margin-left:8px;">
+          </el-input-number>
+          <span class="unit-label">次（0 = 不限）</span>
+        </el-form-item>
         <el-form-item label="启用">
           <el-switch v-model="form.enabled"
                      active-text="包含在全部启动中" inactive-text="跳过">
@@ -211,6 +257,12 @@ const App = {
           </el-switch>
           <div class="setting-hint">打开软件后自动启动所有已启用的进程</div>
         </el-form-item>
+        <el-form-item label="同时启动进程数">
+          <el-input-number v-model="config.launchConcurrency" :min="0" :max="64"
+                           :step="1" controls-position="right">
+          </el-input-number>
+          <div class="setting-hint">全部启动时并行创建进程的上限，0 = 按 CPU 核数</div>
+        </el-form-item>
       </el-form>
       <template #footer>
         <el-button @click="settingsVisible = false">取消</el-button>
@@ -221,7 +273,7 @@ const App = {
   setup() {
     // ── State ──────────────────────────────────────────────────────────────
     const processes = ref([]);
-    const config    = reactive({ autoStartOnOpen: false });
+    const config    = reactive({ autoStartOnOpen: false, launchConcurrency: 0 });
 
     // Dialog
     const dialogVisible = ref(false);
@@ -238,6 +290,13 @@ const App = {
       guardDelaySeconds:1,
       enabled:          true,
       background:       false,
+      priority:         0,
+      dependsOn:        [],
+      restartOn:        'always',
+      restartCodesText: '',
+      backoffMaxSeconds:60,
+      maxRestarts:      10,
+      restartWindowSeconds: 300,
     });
     const rules = {
       name: [{ required: true, message: '请输入名称', trigger: 'blur' }],
@@ -250,6 +309,10 @@ const App = {
     const runningCount = computed(() =>
       processes.value.filter(p => p.status === 'running' || p.status === 'restarting').length
     );
+    // 可选作依赖的进程：除正在编辑的进程自身以外的全部进程
+    const dependencyOptions = computed(() =>
+      processes.value.filter(p => p.id !== form.id)
+    );
 
     // ── Helpers ────────────────────────────────────────────────────────────
     function statusType(s) {
@@ -260,6 +323,21 @@ const App = {
       const map = { running: '运行中', stopped: '已停止', starting: '启动中', restarting: '重启中', failed: '启动失败' };
       return map[s] ?? s;
     }
+    function backoffTip(row) {
+      const b = row.backoff;
+      if (!b) return '';
+      if (b.tripped && row.status === 'failed')
+        return `频繁崩溃：${b.recent} 次守护重启后已停止守护，手动启动后恢复`;
+      if (row.status === 'restarting' && b.attempt > 0)
+        return `连续第 ${b.attempt} 次重启，退避 ${(b.delayMs / 1000).toFixed(1)} 秒`;
+      if (b.attempt > 0) return `最近连续守护重启 ${b.attempt} 次`;
+      return '';
+    }
+    // "1, 3, 0xC0000005, -1073741819" → 无符号退出码列表
+    function parseCodes(text) {
+      return text.split(/[,，\s]+/).filter(Boolean).map(Number)
+                 .filter(Number.isInteger).map(n => n >>> 0);
+    }
     function isRunning(row) {
       return row.status === 'running' || row.status === 'starting' || row.status === 'restarting';
     }
@@ -282,7 +360,9 @@ const App = {
       dialogMode.value = 'add';
       Object.assign(form, {
         id: '', name: '', path: '', type: 'exe', args: '',
-        delaySeconds: 0, guardEnabled: true, guardDelaySeconds: 1, enabled: true, background: false
+        delaySeconds: 0, guardEnabled: true, guardDelaySeconds: 1, enabled: true, background: false,
+        priority: 0, dependsOn: [], restartOn: 'always', restartCodesText: '',
+        backoffMaxSeconds: 60, maxRestarts: 10, restartWindowSeconds: 300
       });
       dialogVisible.value = true;
     }
@@ -290,6 +370,9 @@ const App = {
     function editProcess(row) {
       dialogMode.value = 'edit';
       Object.assign(form, { ...row });
+      // 已被删除的进程不再显示为依赖
+      form.dependsOn = (row.dependsOn || []).filter(id => processes.value.some(p => p.id === id));
+      form.restartCodesText = (row.restartCodes || []).join(', ');
       dialogVisible.value = true;
     }
 
@@ -321,6 +404,13 @@ const App = {
           guardDelaySeconds:form.guardDelaySeconds,
           enabled:          form.enabled,
           background:       form.background,
+          priority:         form.priority,
+          dependsOn:        form.dependsOn,
+          restartOn:        form.restartOn,
+          restartCodes:     parseCodes(form.restartCodesText),
+          backoffMaxSeconds:form.backoffMaxSeconds,
+          maxRestarts:      form.maxRestarts,
+          restartWindowSeconds: form.restartWindowSeconds,
         };
         if (dialogMode.value === 'add') {
           postMsg({ action: 'addProcess', process: payload });
@@ -336,7 +426,10 @@ const App = {
     }
 
     function saveSettings() {
-      postMsg({ action: 'saveConfig', config: { autoStartOnOpen: config.autoStartOnOpen } });
+      postMsg({ action: 'saveConfig', config: {
+        autoStartOnOpen:   config.autoStartOnOpen,
+        launchConcurrency: config.launchConcurrency,
+      } });
       settingsVisible.value = false;
       ElementPlus.ElMessage.success('设置已保存');
     }
@@ -354,7 +447,7 @@ const App = {
         case 'processStatusChanged': {
           const idx = processes.value.findIndex(p => p.id === data.id);
           if (idx !== -1) {
-            processes.value[idx] = { ...processes.value[idx], status: data.status, pid: data.pid ?? 0 };
+            processes.value[idx] = { ...processes.value[idx], status: data.status, pid: data.pid ?? 0, backoff: data.backoff };
             // 重新赋值以触发响应式更新
             processes.value = [...processes.value];
           }
@@ -367,7 +460,8 @@ const App = {
           break;
 
         case 'configResponse':
-          config.autoStartOnOpen = !!data.autoStartOnOpen;
+          config.autoStartOnOpen   = !!data.autoStartOnOpen;
+          config.launchConcurrency = data.launchConcurrency ?? 0;
           break;
 
         default:
@@ -389,8 +483,8 @@ const App = {
       processes, config,
       dialogVisible, dialogMode, form, formRef, rules,
       settingsVisible,
-      runningCount,
-      statusType, statusLabel, isRunning, autoDetectType,
+      runningCount, dependencyOptions,
+      statusType, statusLabel, backoffTip, isRunning, autoDetectType,
       startAll, stopAll, toggleProcess,
       addProcess, editProcess, deleteProcess,
       openFilePicker, submitForm,
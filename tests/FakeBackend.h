@@ -0,0 +1,257 @@
+// FakeBackend.h  -  不创建真实进程的 IProcessBackend 与 ISupervisorHost，供 Supervisor 测试与基准使用
+// 进程只是一条记录：测试调用 exit() 或 Supervisor 调用 killTree() 时，退出回调由后端自己的线程
+// 异步送达，与 Win32 / POSIX 后端一样不会在调用方持有的锁内回调
+#pragma once
+#include "Supervisor.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace test {
+
+class FakeProcessBackend : public IProcessBackend {
+public:
+    static constexpr uint32_t kKilledCode = 137;   // killTree 结束的进程上报的退出码
+
+    // 每次启动后调用，返回值非负时进程随即以该退出码退出（模拟启动即崩溃），可表示全部 32 位退出码
+    std::function<int64_t(const SpawnSpec&)> exitOnSpawn;
+
+    FakeProcessBackend() : m_thread(&FakeProcessBackend::deliverLoop, this) {}
+
+    ~FakeProcessBackend() override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    // 路径在 failPaths 中时启动失败
+    void failPath(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failPaths.insert(path);
+    }
+
+    std::unique_ptr<IProcess> spawn(const SpawnSpec& spec, std::string& error) override {
+        uint32_t pid;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_failPaths.count(spec.path)) {
+                error = "fake spawn failure";
+                return nullptr;
+            }
+            pid = m_nextPid++;
+            m_procs.emplace(pid, Entry{});
+            ++m_spawned;
+        }
+        int64_t code = exitOnSpawn ? exitOnSpawn(spec) : -1;
+        if (code >= 0) exit(pid, (uint32_t)code);
+        return std::make_unique<Process>(*this, pid);
+    }
+
+    std::vector<uint32_t> listChildren(uint32_t) override { return {}; }
+
+    // 让进程以 code 退出；回调注册之前退出的进程等注册后再送达
+    void exit(uint32_t pid, uint32_t code) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_procs.find(pid);
+        if (it == m_procs.end() || it->second.exited) return;
+        it->second.exited = true;
+        it->second.code   = code;
+        if (it->second.armed) queueLocked(pid);
+    }
+
+    size_t spawned() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spawned;
+    }
+
+    // 尚未退出的进程数
+    size_t alive() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t n = 0;
+        for (const auto& [pid, e] : m_procs) n += !e.exited;
+        return n;
+    }
+
+    // 已送达的退出回调数
+    size_t delivered() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_delivered;
+    }
+
+private:
+    struct Entry {
+        IProcess::ExitCallback onExit;
+        bool     armed  = false;
+        bool     exited = false;
+        uint32_t code   = 0;
+    };
+
+    class Process : public IProcess {
+    public:
+        Process(FakeProcessBackend& backend, uint32_t pid) : m_backend(backend), m_pid(pid) {}
+        ~Process() override { m_backend.release(m_pid); }
+        uint32_t pid() const override { return m_pid; }
+        void killTree() override { m_backend.exit(m_pid, kKilledCode); }
+        void waitForExit(ExitCallback onExit) override { m_backend.arm(m_pid, std::move(onExit)); }
+
+    private:
+        FakeProcessBackend& m_backend;
+        uint32_t            m_pid;
+    };
+
+    void queueLocked(uint32_t pid) {
+        m_queue.push_back(pid);
+        m_cv.notify_all();
+    }
+
+    void arm(uint32_t pid, IProcess::ExitCallback onExit) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_procs.find(pid);
+        if (it == m_procs.end()) return;
+        it->second.onExit = std::move(onExit);
+        it->second.armed  = true;
+        if (it->second.exited) queueLocked(pid);
+    }
+
+    // 进程对象析构：不再回调；回调正在其他线程执行时等它返回
+    void release(uint32_t pid) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_procs.find(pid);
+        if (it != m_procs.end()) {
+            it->second.onExit = nullptr;
+            it->second.armed  = true;
+            if (it->second.exited) m_procs.erase(it);
+            return;
+        }
+        if (std::this_thread::get_id() != m_thread.get_id())
+            m_cv.wait(lock, [&] { return m_running != pid; });
+    }
+
+    void deliverLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_cv.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+            uint32_t pid = m_queue.front();
+            m_queue.pop_front();
+            auto it = m_procs.find(pid);
+            if (it == m_procs.end()) continue;
+            IProcess::ExitCallback cb = std::move(it->second.onExit);
+            uint32_t code = it->second.code;
+            m_procs.erase(it);
+            m_running = pid;
+            ++m_delivered;
+            lock.unlock();
+            if (cb) cb(code);
+            lock.lock();
+            m_running = 0;
+            m_cv.notify_all();
+        }
+    }
+
+    std::mutex              m_mutex;   // 保护以下状态
+    std::condition_variable m_cv;
+    std::unordered_map<uint32_t, Entry> m_procs;
+    std::unordered_set<std::string>     m_failPaths;
+    std::deque<uint32_t>    m_queue;
+    uint32_t                m_nextPid   = 1000;
+    uint32_t                m_running   = 0;
+    size_t                  m_spawned   = 0;
+    size_t                  m_delivered = 0;
+    bool                    m_stop      = false;
+    std::thread             m_thread;   // 最后构造：启动时其余成员均已就绪
+};
+
+// 配置由测试直接发布；退出直接转交 Supervisor，状态变更只计数
+class FakeHost : public ISupervisorHost {
+public:
+    Supervisor* sup = nullptr;
+
+    void setConfig(std::vector<ProcessConfig> procs, int launchConcurrency = 0) {
+        auto snap = std::make_shared<ConfigSnapshot>();
+        snap->config.processes = std::move(procs);
+        snap->config.launchConcurrency = launchConcurrency;
+        snap->reindex();
+        std::atomic_store(&m_config, ConfigPtr(std::move(snap)));
+    }
+
+    void setValidation(ValidationPtr v) { std::atomic_store(&m_validation, std::move(v)); }
+
+    ConfigPtr     config() override { return std::atomic_load(&m_config); }
+    ValidationPtr validation() override { return std::atomic_load(&m_validation); }
+    std::string   checkPath(const std::string&) override { return {}; }
+    void          revalidate() override {}
+
+    void processExited(const std::string& id, uint32_t pid, uint32_t exitCode) override {
+        sup->onProcessExited(id, pid, exitCode);
+    }
+
+    void statusChanged(const std::string& id, ProcStatus status) override {
+        ++statusChanges;
+        if (onStatus) onStatus(id, status);
+    }
+
+    void log(const std::string& line) override {
+        if (!keepLog) return;
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        m_lines.push_back(line);
+    }
+
+    // 是否有包含 text 的日志行
+    bool logged(const std::string& text) {
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        for (const auto& l : m_lines)
+            if (l.find(text) != std::string::npos) return true;
+        return false;
+    }
+
+    std::atomic<size_t> statusChanges{ 0 };
+    bool                keepLog = true;
+    // 在发出通知的线程上同步调用，可用来在两步操作之间插入事件
+    std::function<void(const std::string&, ProcStatus)> onStatus;
+
+private:
+    ConfigPtr     m_config     = std::make_shared<ConfigSnapshot>();
+    ValidationPtr m_validation = std::make_shared<ConfigValidation>();
+    std::mutex    m_logMutex;
+    std::vector<std::string> m_lines;
+};
+
+// 守护默认关闭、立即启动的进程配置
+inline ProcessConfig fakeProcess(const std::string& id) {
+    ProcessConfig p;
+    p.id   = id;
+    p.name = id;
+    p.path = "/fake/" + id;
+    p.type = "exe";
+    p.guardEnabled = false;
+    return p;
+}
+
+// 轮询直到 cond 成立或超时
+template <class F>
+bool waitFor(F&& cond, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto until = std::chrono::steady_clock::now() + timeout;
+    while (!cond()) {
+        if (std::chrono::steady_clock::now() >= until) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+} // namespace test
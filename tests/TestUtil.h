@@ -0,0 +1,66 @@
+// TestUtil.h  -  单元测试共用的断言与用例注册
+// 每个测试程序由若干 TEST(name) 用例组成，main 中调用 runTests()；
+// CHECK 失败时打印位置并记为失败，继续执行后续断言
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace test {
+
+struct Case {
+    const char*           name;
+    std::function<void()> fn;
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> list;
+    return list;
+}
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> fn) { cases().push_back({ name, std::move(fn) }); }
+};
+
+inline int runTests() {
+    for (const auto& c : cases()) {
+        int before = failures();
+        std::printf("[ RUN  ] %s\n", c.name);
+        std::fflush(stdout);
+        c.fn();
+        std::printf("[ %s ] %s\n", failures() == before ? " OK " : "FAIL", c.name);
+    }
+    std::printf("%zu cases, %d failed checks\n", cases().size(), failures());
+    return failures() ? 1 : 0;
+}
+
+} // namespace test
+
+#define TEST_CAT2_(a, b) a##b
+#define TEST_CAT_(a, b) TEST_CAT2_(a, b)
+#define TEST(name) \
+    static void name(); \
+    static test::Registrar TEST_CAT_(name, _reg)(#name, name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++test::failures(); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        if (!((a) == (b))) { \
+            std::printf("  %s:%d: CHECK_EQ(%s, %s) failed\n", __FILE__, __LINE__, #a, #b); \
+            ++test::failures(); \
+        } \
+    } while (0)
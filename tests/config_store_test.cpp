@@ -0,0 +1,307 @@
+// config_store_test.cpp  -  ConfigStore：在落盘的任意时刻杀掉进程后，config.json 是完整的旧文件或新文件，
+// load() 恢复最后一次提交的状态
+#include "TestUtil.h"
+#include "ConfigStore.h"
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 测试用的临时目录，析构时删除
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char tmpl[] = "/tmp/pm_store_XXXXXX";
+        path = mkdtemp(tmpl);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+    std::string file(const char* name) const { return path + "/" + name; }
+};
+
+// 第 n 版配置：开头写版本号，足够大使写入跨越多次系统调用
+std::string version(int n) {
+    std::string s = "{\"version\":" + std::to_string(n) + ",\"pad\":\"";
+    s.append(256 * 1024 + n * 131, char('a' + n % 26));
+    s += "\"}";
+    return s;
+}
+
+ProcessConfig proc(const std::string& id, const std::string& args = {}) {
+    ProcessConfig p;
+    p.id   = id;
+    p.name = id;
+    p.path = "/srv/" + id;
+    p.type = "exe";
+    p.args = args;
+    return p;
+}
+
+std::string dump(const AppConfig& cfg) {
+    return sj::encode(cfg, true);
+}
+
+std::string contents(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+std::string loaded(const TempDir& dir) {
+    ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+    ConfigSnapshot snap;
+    CHECK(store.load(snap));
+    return dump(snap.config);
+}
+
+// 在子进程中执行 run 后以 SIGKILL 结束：不析构、不刷出任何缓冲区
+bool killedAfter(const std::function<void()>& run) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        run();
+        raise(SIGKILL);
+        _exit(1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+}
+
+// config.json 与某一版完全一致时返回版本号，否则返回 -1
+int committedVersion(const std::string& path, int upTo) {
+    std::string got = contents(path);
+    for (int n = 0; n <= upTo; ++n)
+        if (got == version(n)) return n;
+    return -1;
+}
+
+// 一步落盘操作，model 为它提交后配置的变化；不提交新状态的步骤（写临时文件、封存等）没有 model
+struct JournalStep {
+    const char*                       name;
+    std::function<void(ConfigStore&)> io;
+    std::function<void(AppConfig&)>   model;
+};
+
+} // namespace
+
+// 按 ConfigService 的调用顺序写出两版快照，在每一步之前杀掉进程
+TEST(kill_at_every_step_keeps_old_or_new_config) {
+    std::string error;
+    struct Step { const char* name; std::function<void(ConfigStore&)> io; int committed; };
+    const std::vector<Step> steps = {
+        { "temp 1",    [&](ConfigStore& s) { CHECK(s.writeTemp(version(1), error)); },  0 },
+        { "replace 1", [&](ConfigStore& s) { CHECK(s.replaceConfig(error)); },          1 },
+        { "temp 2",    [&](ConfigStore& s) { CHECK(s.writeTemp(version(2), error)); },  1 },
+        { "replace 2", [&](ConfigStore& s) { CHECK(s.replaceConfig(error)); },          2 },
+    };
+
+    int expected = 0;
+    for (size_t k = 0; k <= steps.size(); ++k) {
+        TempDir dir;
+        {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            CHECK(store.writeTemp(version(0), error) && store.replaceConfig(error));
+        }
+        CHECK(killedAfter([&] {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            for (size_t i = 0; i < k; ++i) steps[i].io(store);
+        }));
+        if (k > 0) expected = steps[k - 1].committed;
+
+        int got = committedVersion(dir.file("config.json"), 2);
+        if (got != expected) std::printf("  killed before step %zu (%s)\n", k, k < steps.size() ? steps[k].name : "end");
+        CHECK_EQ(got, expected);
+
+        // 恢复后继续保存：残留的临时文件被覆盖
+        ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+        CHECK(store.writeTemp(version(3), error) && store.replaceConfig(error));
+        CHECK_EQ(committedVersion(dir.file("config.json"), 3), 3);
+        CHECK(!std::filesystem::exists(dir.file("config.json.tmp")));
+    }
+}
+
+// 子进程不停地保存新版本，在随机时刻被杀掉：config.json 始终是某一版的完整内容
+TEST(kill_during_save_loop_never_tears_config) {
+    constexpr int kRounds = 30;
+    constexpr int kVersions = 200;
+    unsigned seed = 12345;
+    for (int round = 0; round < kRounds; ++round) {
+        TempDir dir;
+        std::string error;
+        {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            CHECK(store.writeTemp(version(0), error) && store.replaceConfig(error));
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            std::string err;
+            for (int n = 1; n <= kVersions; ++n) {
+                if (!store.writeTemp(version(n), err) || !store.replaceConfig(err)) _exit(2);
+            }
+            _exit(0);
+        }
+        seed = seed * 1103515245 + 12345;
+        timespec delay{ 0, long(seed % 20000) * 1000 };   // 0 ~ 20 ms
+        nanosleep(&delay, nullptr);
+        kill(pid, SIGKILL);
+        int status = 0;
+        waitpid(pid, &status, 0);
+        CHECK(WIFSIGNALED(status) || (WIFEXITED(status) && WEXITSTATUS(status) == 0));
+
+        int got = committedVersion(dir.file("config.json"), kVersions);
+        if (got < 0) std::printf("  round %d: config.json is torn\n", round);
+        CHECK(got >= 0);
+    }
+}
+
+// 按 ConfigService 的调用顺序：追加修改、日志过大时封存、写出覆盖封存内容的快照、删除封存日志。
+// 在每一步之前杀掉进程，重新加载的结果都应等于此前已提交的全部修改
+TEST(kill_at_every_step_recovers_last_committed_state) {
+    AppConfig base;
+    base.processes = { proc("a"), proc("b"), proc("c") };
+
+    AppConfig sealedState = base;   // 封存时的配置，即随后写出的快照内容
+    sealedState.processes.push_back(proc("d"));
+    sealedState.processes[1].args = "--v2";
+    sealedState.processes.erase(sealedState.processes.begin());
+    const std::string snapshot = dump(sealedState);
+
+    std::string error;
+    const std::vector<JournalStep> steps = {
+        { "open",     [](ConfigStore& s) { s.openJournal(); }, nullptr },
+        { "add d",    [](ConfigStore& s) { s.appendAdd(proc("d")); },
+                      [](AppConfig& c) { c.processes.push_back(proc("d")); } },
+        { "update b", [](ConfigStore& s) { s.appendUpdate(proc("b", "--v2")); },
+                      [](AppConfig& c) { c.processes[1].args = "--v2"; } },
+        { "delete a", [](ConfigStore& s) { s.appendDelete("a"); },
+                      [](AppConfig& c) { c.processes.erase(c.processes.begin()); } },
+        { "seal",     [&](ConfigStore& s) { CHECK(s.seal(error)); }, nullptr },
+        { "settings", [](ConfigStore& s) { AppConfig c; c.launchConcurrency = 3; s.appendSettings(c); },
+                      [](AppConfig& c) { c.launchConcurrency = 3; } },
+        { "temp",     [&](ConfigStore& s) { CHECK(s.writeTemp(snapshot, error)); }, nullptr },
+        { "replace",  [&](ConfigStore& s) { CHECK(s.replaceConfig(error)); }, nullptr },
+        { "unseal",   [](ConfigStore& s) { CHECK(s.removeSealed()); }, nullptr },
+        { "add e",    [](ConfigStore& s) { s.appendAdd(proc("e")); },
+                      [](AppConfig& c) { c.processes.push_back(proc("e")); } },
+    };
+
+    AppConfig expected = base;
+    for (size_t k = 0; k <= steps.size(); ++k) {
+        TempDir dir;
+        {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            CHECK(store.writeTemp(dump(base), error) && store.replaceConfig(error));
+        }
+        CHECK(killedAfter([&] {
+            ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+            for (size_t i = 0; i < k; ++i) steps[i].io(store);
+        }));
+        if (k > 0 && steps[k - 1].model) steps[k - 1].model(expected);
+
+        std::string got = loaded(dir);
+        if (got != dump(expected)) std::printf("  killed before step %zu (%s)\n", k, k < steps.size() ? steps[k].name : "end");
+        CHECK_EQ(got, dump(expected));
+        // 临时文件已写完、尚未替换时，config.json 仍是完整的旧文件
+        if (k < steps.size() && std::string(steps[k].name) == "replace")
+            CHECK_EQ(contents(dir.file("config.json")), dump(base));
+
+        // 恢复后继续写入：残留的临时文件被覆盖，新记录接在已有日志之后
+        ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+        ConfigSnapshot snap;
+        CHECK(store.load(snap));
+        CHECK(store.openJournal());
+        CHECK(store.appendAdd(proc("z")));
+        snap.config.processes.push_back(proc("z"));
+        CHECK_EQ(loaded(dir), dump(snap.config));
+        CHECK(store.writeTemp(dump(snap.config), error) && store.replaceConfig(error));
+        CHECK_EQ(loaded(dir), dump(snap.config));
+    }
+}
+
+// 写到一半被杀掉的记录只丢失它自己，重新打开后追加的记录不受影响
+TEST(torn_journal_tail_does_not_swallow_next_record) {
+    TempDir dir;
+    std::string error;
+    {
+        ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+        CHECK(store.writeTemp(dump(AppConfig{}), error) && store.replaceConfig(error));
+        CHECK(store.openJournal());
+        CHECK(store.appendAdd(proc("a")));
+    }
+    std::ofstream(dir.file("config.journal"), std::ios::binary | std::ios::app) << R"({"op":"add","process":{"id":"b)";
+
+    ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+    CHECK(store.openJournal());
+    CHECK(store.appendAdd(proc("c")));
+
+    ConfigSnapshot snap;
+    size_t bad = 0;
+    snap.reindex();
+    CHECK_EQ(store.recover(snap, true, bad), (size_t)2);
+    CHECK_EQ(bad, (size_t)1);
+    CHECK(snap.find("a") && snap.find("c") && !snap.find("b"));
+}
+
+// config.json 损坏时日志失去重放基准：不重放，改名为 *.bad 原样保留
+TEST(corrupt_config_sets_journals_aside) {
+    TempDir dir;
+    std::string error;
+    std::ofstream(dir.file("config.json"), std::ios::binary) << R"({"processes":[)";
+    {
+        ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+        CHECK(store.openJournal());
+        CHECK(store.appendAdd(proc("a")));
+        CHECK(store.seal(error));
+        CHECK(store.appendAdd(proc("b")));
+    }
+    std::string sealed  = contents(dir.file("config.journal.old"));
+    std::string current = contents(dir.file("config.journal"));
+    CHECK(!sealed.empty() && !current.empty());
+
+    ConfigStore store(dir.file("config.json"), dir.file("config.journal"));
+    ConfigSnapshot snap;
+    CHECK(!store.load(snap));
+    CHECK(snap.config.processes.empty());
+    CHECK(!std::filesystem::exists(dir.file("config.journal")));
+    CHECK(!std::filesystem::exists(dir.file("config.journal.old")));
+    CHECK_EQ(contents(dir.file("config.journal.old.bad")), sealed);
+    CHECK_EQ(contents(dir.file("config.journal.bad")), current);
+    // 没有可移开的日志时不做任何事
+    CHECK_EQ(store.setAsideJournals(), (size_t)0);
+}
+
+// 缓存只在内容哈希、字段表与正文都一致时采用，否则由调用方回退到解析 config.json
+TEST(cache_round_trips_and_rejects_stale_or_torn_bytes) {
+    AppConfig cfg;
+    cfg.launchConcurrency = 4;
+    cfg.processes = { proc("a", "--x"), proc("b") };
+    cfg.processes[1].dependsOn = { "a" };
+    const std::string text  = dump(cfg);
+    const uint64_t    hash  = ConfigStore::contentHash(text);
+    const std::string bytes = ConfigStore::encodeCache(hash, cfg);
+
+    AppConfig out;
+    CHECK(ConfigStore::decodeCache(bytes, hash, out));
+    CHECK_EQ(dump(out), text);
+
+    AppConfig untouched;
+    untouched.launchConcurrency = 7;
+    CHECK(!ConfigStore::decodeCache(bytes, hash + 1, untouched));
+    CHECK(!ConfigStore::decodeCache(std::string_view(bytes).substr(0, bytes.size() - 1), hash, untouched));
+    std::string flipped = bytes;
+    flipped.back() ^= 1;
+    CHECK(!ConfigStore::decodeCache(flipped, hash, untouched));
+    CHECK(!ConfigStore::decodeCache({}, hash, untouched));
+    CHECK_EQ(untouched.launchConcurrency, 7);
+}
+
+int main() { return test::runTests(); }
@@ -0,0 +1,105 @@
+// config_test.cpp  -  配置数据结构：解码默认值、热重载时的 id 对应与差异、重启规则检查
+#include "TestUtil.h"
+#include "ConfigTypes.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+// 与 ConfigService::reload 相同的步骤：解码、沿用 prev 的 id、建索引
+std::shared_ptr<ConfigSnapshot> load(const std::string& text, const ConfigSnapshot* prev) {
+    auto snap = std::make_shared<ConfigSnapshot>();
+    sj::decode(text, snap->config);
+    assignMissingIds(snap->config, prev);
+    snap->reindex();
+    return snap;
+}
+
+bool unchanged(const ConfigDiff& d) {
+    return d.added.empty() && d.removed.empty() && d.relaunch.empty();
+}
+
+} // namespace
+
+TEST(missing_fields_get_defaults) {
+    AppConfig cfg;
+    sj::decode(R"({"processes":[{"name":"a","path":"C:\\svc\\run.CMD"},{"name":"b","path":"worker.exe"}]})", cfg);
+    CHECK_EQ(cfg.processes.size(), (size_t)2);
+    CHECK_EQ(cfg.processes[0].type, std::string("bat"));
+    CHECK_EQ(cfg.processes[1].type, std::string("exe"));
+    CHECK(cfg.processes[0].id.empty());   // 由 assignMissingIds 补上
+    CHECK_EQ(assignMissingIds(cfg), (size_t)2);
+    CHECK(!cfg.processes[0].id.empty());
+    CHECK(cfg.processes[0].id != cfg.processes[1].id);
+}
+
+TEST(idless_entry_survives_reloads) {
+    const std::string text =
+        R"({"processes":[{"name":"web","path":"/srv/web","args":"-p 80"},{"id":"db","name":"db","path":"/srv/db"}]})";
+    auto first = load(text, nullptr);
+    const std::string id = first->config.processes[0].id;
+    CHECK(!id.empty());
+
+    // 同一文件连续重新加载两次：id 不变，没有新增、删除或重启
+    auto second = load(text, first.get());
+    CHECK_EQ(second->config.processes[0].id, id);
+    ConfigDiff diff;
+    CHECK(!diffConfig(*first, *second, diff));
+    CHECK(unchanged(diff));
+
+    auto third = load(text, second.get());
+    CHECK_EQ(third->config.processes[0].id, id);
+    CHECK(!diffConfig(*second, *third, diff));
+    CHECK(unchanged(diff));
+
+    // 只改了参数：仍是同一条目，按启动参数变化重启
+    auto edited = load(R"({"processes":[{"name":"web","path":"/srv/web","args":"-p 81"},{"id":"db","name":"db","path":"/srv/db"}]})",
+                       third.get());
+    CHECK_EQ(edited->config.processes[0].id, id);
+    CHECK(diffConfig(*third, *edited, diff));
+    CHECK(diff.added.empty() && diff.removed.empty());
+    CHECK_EQ(diff.relaunch.size(), (size_t)1);
+}
+
+TEST(idless_entries_matched_by_position_then_name) {
+    auto cur = load(R"({"processes":[{"name":"a","path":"/a"},{"name":"b","path":"/b"},{"name":"dup","path":"/d1"},{"name":"dup","path":"/d2"}]})",
+                    nullptr);
+    const auto& old = cur->config.processes;
+
+    // 插入到最前面：位置全部错开，a、b 按唯一名称找回；重名的 dup 无法对应，生成新 id
+    auto next = load(R"({"processes":[{"name":"new","path":"/n"},{"name":"b","path":"/b2"},{"name":"a","path":"/a"},{"name":"dup","path":"/d1"}]})",
+                     cur.get());
+    const auto& procs = next->config.processes;
+    CHECK_EQ(procs[1].id, old[1].id);
+    CHECK_EQ(procs[2].id, old[0].id);
+    CHECK(procs[3].id != old[2].id && procs[3].id != old[3].id);
+    for (const auto& p : old) CHECK(procs[0].id != p.id);
+
+    // 显式写出的 id 不会被重复分配给其他条目
+    auto explicitId = load("{\"processes\":[{\"id\":\"" + old[0].id + "\",\"name\":\"x\",\"path\":\"/x\"},"
+                           "{\"name\":\"a\",\"path\":\"/a\"}]}", cur.get());
+    CHECK_EQ(explicitId->config.processes[0].id, old[0].id);
+    CHECK(explicitId->config.processes[1].id != old[0].id);
+    CHECK_EQ(explicitId->index.size(), (size_t)2);
+}
+
+// restartOn 只接受四种取值；拼错的规则由校验报告，而不是悄悄按 "always" 守护
+TEST(unknown_restart_rule_is_reported) {
+    AppConfig cfg;
+    sj::decode(R"({"processes":[{"name":"a","path":"/a"},{"name":"b","path":"/b","restartOn":"never"},)"
+               R"({"name":"c","path":"/c","restartOn":"on_failure"}]})", cfg);
+    CHECK(checkRestartRule(cfg.processes[0]).empty());
+    CHECK(checkRestartRule(cfg.processes[1]).empty());
+    std::string msg = checkRestartRule(cfg.processes[2]);
+    CHECK(msg.find("on_failure") != std::string::npos);
+
+    ConfigValidation v;
+    v.issues["c"] = { "/c", msg, true };
+    ProcessConfig moved = cfg.processes[2];
+    moved.id   = "c";
+    moved.path = "/elsewhere";
+    CHECK(v.issueOf(moved) != nullptr);   // 与路径无关，改路径后仍然有效
+}
+
+int main() { return test::runTests(); }
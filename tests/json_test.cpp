@@ -0,0 +1,327 @@
+// json_test.cpp  -  SimpleJson 单元测试
+#include "TestUtil.h"
+#include "SimpleJson.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string compact(const sj::Value& v) {
+    std::string out;
+    sj::write(out, v);
+    return out;
+}
+
+// 记录分配与释放的内存资源，用于确认对象落在哪个资源上
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t live = 0;
+
+private:
+    void* do_allocate(size_t n, size_t a) override {
+        ++live;
+        return std::pmr::new_delete_resource()->allocate(n, a);
+    }
+    void do_deallocate(void* p, size_t n, size_t a) override {
+        --live;
+        std::pmr::new_delete_resource()->deallocate(p, n, a);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+};
+
+struct Ranges {
+    int                   i   = -7;
+    unsigned              u   = 7;
+    int64_t               big = -7;
+    uint16_t              w   = 7;
+    float                 f   = 7;
+    std::vector<uint32_t> codes;
+};
+
+SJ_FIELDS(Ranges, i, u, big, w, f, codes)
+
+// SJ_FIELDS 的成员上限与 FieldMask 的位数一致
+struct Wide {
+    int m0 = 0, m1 = 0, m2 = 0, m3 = 0, m4 = 0, m5 = 0, m6 = 0, m7 = 0, m8 = 0, m9 = 0,
+        m10 = 0, m11 = 0, m12 = 0, m13 = 0, m14 = 0, m15 = 0, m16 = 0, m17 = 0, m18 = 0, m19 = 0,
+        m20 = 0, m21 = 0, m22 = 0, m23 = 0, m24 = 0, m25 = 0, m26 = 0, m27 = 0, m28 = 0, m29 = 0,
+        m30 = 0, m31 = 0, m32 = 0, m33 = 0, m34 = 0, m35 = 0, m36 = 0, m37 = 0, m38 = 0, m39 = 0,
+        m40 = 0, m41 = 0, m42 = 0, m43 = 0, m44 = 0, m45 = 0, m46 = 0, m47 = 0, m48 = 0, m49 = 0,
+        m50 = 0, m51 = 0, m52 = 0, m53 = 0, m54 = 0, m55 = 0, m56 = 0, m57 = 0, m58 = 0, m59 = 0,
+        m60 = 0, m61 = 0, m62 = 0, m63 = 0;
+};
+
+SJ_FIELDS(Wide, m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15,
+          m16, m17, m18, m19, m20, m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31,
+          m32, m33, m34, m35, m36, m37, m38, m39, m40, m41, m42, m43, m44, m45, m46, m47,
+          m48, m49, m50, m51, m52, m53, m54, m55, m56, m57, m58, m59, m60, m61, m62, m63)
+
+struct LongNumber {
+    double d = 0;
+};
+
+SJ_FIELDS(LongNumber, d)
+
+struct Counters {
+    uint32_t small = 0;
+    uint64_t big   = 0;
+};
+
+SJ_FIELDS(Counters, small, big)
+
+bool throws(void (*fn)()) {
+    try { fn(); } catch (const std::runtime_error&) { return true; }
+    return false;
+}
+
+} // namespace
+
+// ─── 数值范围 ────────────────────────────────────────────────────────────────
+TEST(value_int_out_of_range_is_mismatch) {
+    CHECK(throws([] { (void)sj::parse("1e300").get_int64(); }));
+    CHECK(throws([] { (void)sj::parse("-1e19").get_int64(); }));
+    CHECK(throws([] { (void)sj::parse("3000000000").get_int(); }));
+    CHECK_EQ(sj::parse("3000000000").get_int64(), 3000000000LL);
+    CHECK_EQ(sj::parse("1e300").get_int64_or(5), 5);
+    CHECK_EQ(sj::parse("3000000000").get_int_or(-1), -1);
+    CHECK_EQ(sj::parse("-2.9").get_int(), -2);   // 范围内的浮点数仍取截断值
+    CHECK_EQ(sj::parse("-9223372036854775808").get_int64(), std::numeric_limits<int64_t>::min());
+    CHECK_EQ(sj::parse("-9223372036854775808.0").get_int64(), std::numeric_limits<int64_t>::min());
+    CHECK(throws([] { (void)sj::parse("9223372036854775808.0").get_int64(); }));
+}
+
+TEST(reader_integer_saturates) {
+    sj::Reader r("[1e300,-1e300,12.7]");
+    r.next();
+    r.next();
+    CHECK_EQ(r.integer(), std::numeric_limits<int64_t>::max());
+    r.next();
+    CHECK_EQ(r.integer(), std::numeric_limits<int64_t>::min());
+    r.next();
+    CHECK_EQ(r.integer(), 12);
+}
+
+// Parser 接受的长数字，Reader（sj::decode 与 ConfigStore::parse 经由它解码）与流模式 Reader 也必须接受
+TEST(reader_accepts_long_numbers) {
+    const std::string digits(300, '1');
+    const std::string json = "[0." + digits + ",1" + digits + ",-0." + std::string(200, '0') + "5e-10]";
+    sj::Value v = sj::parse(json);
+    CHECK_EQ(v.size(), (size_t)3);
+
+    sj::Reader r(json);
+    std::istringstream in(json);
+    sj::Reader s(in, 7);   // 块远小于数字长度，数字跨越多次补充
+    for (sj::Reader* rd : { &r, &s }) {
+        CHECK(rd->next() == sj::Event::StartArray);
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK(rd->next() == sj::Event::Number);
+            CHECK_EQ(rd->number(), v[i].get_number_or(0));
+        }
+        CHECK(rd->next() == sj::Event::EndArray);
+        CHECK(rd->next() == sj::Event::End);
+    }
+
+    LongNumber out;
+    CHECK_EQ(sj::decode("{\"d\":0." + digits + "}", out), sj::fieldMask<LongNumber>("d"));
+    CHECK(out.d > 0.111 && out.d < 0.112);
+}
+
+// 超过 INT64_MAX 的无符号数按原值输出，不经 long long 转换变成负数
+TEST(writer_keeps_unsigned_values) {
+    std::string out;
+    sj::Writer w(out);
+    w.startArray()
+        .value(std::numeric_limits<unsigned long long>::max())
+        .value((unsigned long long)1 << 63)
+        .value((unsigned long long)INT64_MAX)
+        .value(std::numeric_limits<unsigned>::max())
+        .value(INT64_MIN)
+        .endArray();
+    CHECK_EQ(out, std::string("[18446744073709551615,9223372036854775808,9223372036854775807,4294967295,-9223372036854775808]"));
+
+    Counters c;
+    c.small = 4294967295u;
+    c.big   = 18446744073709551615u;
+    CHECK_EQ(sj::encode(c), std::string(R"({"small":4294967295,"big":18446744073709551615})"));
+    // 文本解析超出 int64 的整数得到 double，与输出的数值一致
+    CHECK_EQ(sj::parse(out)[0].get_number_or(0), 18446744073709551615.0);
+}
+
+TEST(lazy_int_out_of_range_returns_default) {
+    sj::Lazy l = sj::Lazy::parse(R"({"a":1e20,"b":4294967296,"c":42})");
+    CHECK_EQ(l["a"].get_int64_or(-1), -1);
+    CHECK_EQ(l["b"].get_int_or(-1), -1);
+    CHECK_EQ(l["b"].get_int64_or(-1), 4294967296LL);
+    CHECK_EQ(l["c"].get_int_or(-1), 42);
+}
+
+TEST(decode_out_of_range_leaves_field_unset) {
+    Ranges r;
+    sj::FieldMask m = sj::decode(
+        R"({"i":1e10,"u":-1,"big":9.3e18,"w":65536,"f":1e39,"codes":[1,-1,4294967296,5,2.5]})", r);
+    CHECK_EQ(m, sj::fieldMask<Ranges>("codes"));
+    CHECK_EQ(r.i, -7);
+    CHECK_EQ(r.u, 7u);
+    CHECK_EQ(r.big, -7);
+    CHECK_EQ(r.w, 7);
+    CHECK_EQ(r.f, 7.0f);
+    CHECK(r.codes == std::vector<uint32_t>({ 1, 5, 2 }));
+
+    Ranges ok;
+    m = sj::decode(R"({"i":-2147483648,"u":4294967295,"big":-9223372036854775808,"w":65535,"f":0.5})", ok);
+    CHECK_EQ(m, ~sj::fieldMask<Ranges>("codes") & 0x1f);
+    CHECK_EQ(ok.i, std::numeric_limits<int>::min());
+    CHECK_EQ(ok.u, 4294967295u);
+    CHECK_EQ(ok.big, std::numeric_limits<int64_t>::min());
+    CHECK_EQ(ok.w, 65535);
+    CHECK_EQ(ok.f, 0.5f);
+}
+
+// ─── 字段表 ──────────────────────────────────────────────────────────────────
+TEST(fields_up_to_64_members) {
+    static_assert(sj::detail::fieldCount<Wide>() == 64, "SJ_FIELDS accepts 64 members");
+    Wide w;
+    sj::FieldMask m = sj::decode(R"({"m0":1,"m32":2,"m63":3})", w);
+    CHECK_EQ(m, ((sj::FieldMask)1 << 0) | ((sj::FieldMask)1 << 32) | ((sj::FieldMask)1 << 63));
+    CHECK_EQ(w.m63, 3);
+    CHECK_EQ(sj::fieldMask<Wide>("m63"), (sj::FieldMask)1 << 63);
+}
+
+// ─── FlatObject 赋值 ─────────────────────────────────────────────────────────
+TEST(object_assign_across_resources) {
+    sj::Document doc;
+    sj::Value& root = doc.parse(R"({"a":{"x":1,"y":"a long string that is heap allocated"}})");
+    // 默认资源上的拷贝赋给 arena 中的对象：不能交换缓冲区
+    sj::Object fresh = sj::parse(R"({"p":1,"q":[1,2,3],"r":"another long heap allocated string"})").get_object();
+    root["a"].get_object() = fresh;
+    CHECK_EQ(root["a"].get_object().resource(), doc.resource());
+    CHECK_EQ(compact(root), R"({"a":{"p":1,"q":[1,2,3],"r":"another long heap allocated string"}})");
+    CHECK(root["a"].get_object().contains("q"));
+    CHECK(!root["a"].get_object().contains("x"));
+}
+
+TEST(object_assign_many_members_rebuilds_index) {
+    CountingResource res;
+    {
+        sj::Object dst(&res);
+        dst["old"] = 1;
+        sj::Object src;
+        for (int i = 0; i < 40; ++i) src["k" + std::to_string(i)] = i;
+        dst = src;
+        CHECK_EQ(dst.size(), (size_t)40);
+        CHECK_EQ(dst.resource(), (std::pmr::memory_resource*)&res);
+        CHECK_EQ(dst.at("k37").get_int(), 37);
+        CHECK(!dst.contains("old"));
+        // 来源对象不受影响
+        CHECK_EQ(src.at("k0").get_int(), 0);
+    }
+    CHECK_EQ(res.live, (size_t)0);
+}
+
+TEST(object_assign_same_resource_swaps) {
+    sj::Object a, b;
+    a["x"] = 1;
+    b["y"] = 2;
+    a = std::move(b);
+    CHECK(a.contains("y"));
+    CHECK(!a.contains("x"));
+}
+
+// ─── 键驻留 ──────────────────────────────────────────────────────────────────
+TEST(standalone_parse_does_not_grow_global_keys) {
+    size_t before = sj::GlobalKeys::instance().size();
+    for (int i = 0; i < 1000; ++i) {
+        sj::Value v = sj::parse("{\"runtime-key-" + std::to_string(i) + "\":1,\"m7\":2}");
+        CHECK(v.contains("runtime-key-" + std::to_string(i)));
+        sj::Value copy = v;
+        CHECK(copy.contains("m7"));
+    }
+    CHECK_EQ(sj::GlobalKeys::instance().size(), before);
+    CHECK(sj::GlobalKeys::instance().find("runtime-key-1") == nullptr);
+}
+
+TEST(field_names_are_global_keys) {
+    // Wide 的成员名由 SJ_FIELDS 在静态初始化时登记，独立对象直接引用表中的副本
+    const sj::InternedKey* g = sj::GlobalKeys::instance().find("m63");
+    CHECK(g != nullptr);
+    sj::Value v = sj::parse(R"({"m63":1,"other":2})");
+    auto it = v.get_object().begin();
+    CHECK(it->first.interned() == g);
+    CHECK((++it)->first.interned()->owned != 0);
+}
+
+TEST(global_keys_concurrent_lookup) {
+    // 查找不加锁：多个线程同时解析、查找，另一个线程登记新键
+    std::vector<std::thread> threads;
+    int bad[4] = {};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &bad] {
+            for (int i = 0; i < 2000; ++i) {
+                sj::Value v = sj::parse(R"({"m1":1,"m2":2,"x":3})");
+                if (!v.contains("m2") || !v.contains("x") || v.contains("y")) ++bad[t];
+            }
+        });
+    }
+    std::thread writer([] {
+        for (int i = 0; i < 200; ++i) sj::GlobalKeys::instance().add("concurrent-" + std::to_string(i));
+    });
+    for (auto& th : threads) th.join();
+    writer.join();
+    for (int b : bad) CHECK_EQ(b, 0);
+    CHECK(sj::GlobalKeys::instance().find("concurrent-199") != nullptr);
+}
+
+TEST(probes_do_not_intern) {
+    sj::Document doc;
+    sj::Value& root = doc.parse(R"({"a":1,"b":{"c":2}})");
+    size_t keys = doc.keys()->size();
+    CHECK_EQ(keys, (size_t)3);
+    CHECK(!root.contains("missing"));
+    CHECK(root.get_object().find("missing") == root.get_object().end());
+    CHECK_EQ(root.get_object().count("nope"), (size_t)0);
+    const sj::Value& croot = root;
+    CHECK_EQ(croot["a"].get_int(), 1);
+    CHECK_EQ(doc.keys()->size(), keys);
+    root["b"]["c"] = 3;   // 已存在的键不重复驻留
+    CHECK_EQ(doc.keys()->size(), keys);
+    root["new"] = 4;      // 新增成员才驻留
+    CHECK_EQ(doc.keys()->size(), keys + 1);
+}
+
+TEST(owned_keys_are_released) {
+    CountingResource res;
+    {
+        sj::Object o(&res);
+        for (int i = 0; i < 20; ++i) o["key-" + std::to_string(i)] = i;
+        o["m0"] = 1;   // 全局键表中的键不占用对象自己的内存
+        CHECK(o.erase("key-3") == 1);
+        CHECK(!o.contains("key-3"));
+        CHECK_EQ(o.at("key-19").get_int(), 19);
+        sj::Object moved(std::move(o));
+        CHECK_EQ(moved.size(), (size_t)20);
+        CHECK(o.empty());
+        sj::Object copy = moved;   // 拷贝在默认资源上自行分配键
+        moved.clear();
+        CHECK_EQ(copy.at("key-7").get_int(), 7);
+    }
+    CHECK_EQ(res.live, (size_t)0);
+}
+
+TEST(copy_outlives_document) {
+    sj::Value copy;
+    {
+        sj::Document doc;
+        copy = doc.parse(R"({"alpha":{"beta":[1,{"gamma":"a long string that is heap allocated"}]}})");
+    }
+    CHECK_EQ(compact(copy), R"({"alpha":{"beta":[1,{"gamma":"a long string that is heap allocated"}]}})");
+    CHECK(copy["alpha"]["beta"][1].contains("gamma"));
+}
+
+int main() { return test::runTests(); }
@@ -0,0 +1,168 @@
+// launch_pool_test.cpp  -  LaunchPool：出队顺序、并发上限（含运行中调低）与 stop 丢弃排队任务
+#include "TestUtil.h"
+#include "FakeBackend.h"
+#include "LaunchPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using test::waitFor;
+using std::chrono::milliseconds;
+
+namespace {
+
+// 任务中等待 open() 的闸门
+struct Gate {
+    void wait() {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_cv.wait(lk, [&] { return m_open; });
+    }
+    void open() {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_open = true;
+        }
+        m_cv.notify_all();
+    }
+
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    bool                    m_open = false;
+};
+
+// 记录同时执行的任务数；begin() 返回包括自身在内的当前数量
+struct ActiveCounter {
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+
+    int begin() {
+        int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        return now;
+    }
+    void end() { --active; }
+};
+
+} // namespace
+
+// 上限为 1，先用一个任务占住唯一的执行位，其余任务全部排队后再放行
+TEST(dequeues_by_priority_then_fifo) {
+    LaunchPool pool(1);
+    Gate gate;
+    std::atomic<bool> started{false};
+    pool.submit(0, [&] { started = true; gate.wait(); });
+    CHECK(waitFor([&] { return started.load(); }));
+
+    std::mutex mutex;
+    std::string order;
+    auto record = [&](char c) {
+        return [&, c] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order += c;
+        };
+    };
+    pool.submit(1, record('a'));
+    pool.submit(5, record('b'));
+    pool.submit(1, record('c'));
+    pool.submit(5, record('d'));
+    pool.submit(3, record('e'));
+    pool.submit(1, record('f'));
+    gate.open();
+
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order.size() == 6;
+    }));
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK_EQ(order, std::string("bdeacf"));
+}
+
+TEST(never_exceeds_limit) {
+    LaunchPool pool(3);
+    ActiveCounter counter;
+    std::atomic<int> done{0};
+    for (int i = 0; i < 40; ++i) {
+        pool.submit(i % 4, [&] {
+            counter.begin();
+            std::this_thread::sleep_for(milliseconds(2));
+            counter.end();
+            ++done;
+        });
+    }
+    CHECK(waitFor([&] { return done.load() == 40; }));
+    CHECK(counter.peak.load() <= 3);
+    CHECK_EQ(counter.peak.load(), 3);
+}
+
+// 4 个任务占满执行位时把上限调到 2：它们照常执行完，之后出队的任务开始时同时执行的不超过 2 个
+TEST(lowered_limit_applies_to_later_tasks) {
+    LaunchPool pool(4);
+    Gate gate;
+    ActiveCounter counter;
+    std::atomic<int> done{0};
+    for (int i = 0; i < 4; ++i) {
+        pool.submit(1, [&] {
+            counter.begin();
+            gate.wait();
+            counter.end();
+            ++done;
+        });
+    }
+    CHECK(waitFor([&] { return counter.active.load() == 4; }));
+
+    std::atomic<int> laterPeak{0};
+    for (int i = 0; i < 20; ++i) {
+        pool.submit(0, [&] {
+            int now = counter.begin();
+            int seen = laterPeak.load();
+            while (now > seen && !laterPeak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(milliseconds(2));
+            counter.end();
+            ++done;
+        });
+    }
+    pool.setLimit(2);
+    gate.open();
+
+    CHECK(waitFor([&] { return done.load() == 24; }));
+    CHECK_EQ(counter.peak.load(), 4);
+    if (laterPeak.load() > 2) std::printf("  %d tasks ran at once after setLimit(2)\n", laterPeak.load());
+    CHECK(laterPeak.load() <= 2);
+}
+
+// stop 等执行中的任务结束，丢弃排队的任务并析构它们捕获的对象，之后的 submit 被忽略
+TEST(stop_drops_queued_tasks) {
+    LaunchPool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<int> ran{0};
+    pool.submit(0, [&] {
+        started = true;
+        std::this_thread::sleep_for(milliseconds(50));
+        ++ran;
+    });
+    CHECK(waitFor([&] { return started.load(); }));
+
+    auto token = std::make_shared<int>(0);
+    for (int i = 0; i < 5; ++i)
+        pool.submit(0, [&, token] { ++ran; });
+    CHECK_EQ(token.use_count(), 6L);
+
+    pool.stop();
+    CHECK_EQ(ran.load(), 1);
+    CHECK_EQ(token.use_count(), 1L);
+
+    pool.submit(0, [&] { ++ran; });
+    std::this_thread::sleep_for(milliseconds(20));
+    CHECK_EQ(ran.load(), 1);
+}
+
+int main() { return test::runTests(); }
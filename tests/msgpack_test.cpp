@@ -0,0 +1,194 @@
+// msgpack_test.cpp  -  MessagePack 编解码与文本 JSON 的往返一致性
+#include "TestUtil.h"
+#include "SimpleJson.hpp"
+#include "SimpleMsgPack.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string compact(const sj::Value& v) {
+    std::string out;
+    sj::write(out, v);
+    return out;
+}
+
+std::string hex(std::string_view bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (unsigned char c : bytes) { out += digits[c >> 4]; out += digits[c & 0xf]; }
+    return out;
+}
+
+// JSON → Value → MessagePack → Value，结果须与直接解析文本一致
+bool roundTrips(const std::string& json) {
+    sj::Value text = sj::parse(json);
+    sj::Value bin = sj::msgpack::decode(sj::msgpack::encode(text));
+    if (compact(bin) == compact(text)) return true;
+    std::printf("  round trip mismatch:\n    json    %s\n    msgpack %s\n", compact(text).c_str(), compact(bin).c_str());
+    return false;
+}
+
+struct Item {
+    std::string           id;
+    int64_t               big = 0;
+    uint32_t              code = 0;
+    int                   n = 0;
+    double                d = 0;
+    bool                  on = false;
+    std::vector<uint32_t> codes;
+};
+
+SJ_FIELDS(Item, id, big, code, n, d, on, codes)
+
+} // namespace
+
+// ─── 语料 ────────────────────────────────────────────────────────────────────
+// 模糊测试的 JSON 种子兼作往返用例；无法解析的种子（截断输入）两条路径都应拒绝
+TEST(corpus_round_trip) {
+    size_t checked = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(PM_FUZZ_CORPUS_DIR)) {
+        if (entry.path().extension() != ".json") continue;
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        bool parsed = true;
+        try { sj::parse(json); } catch (const std::runtime_error&) { parsed = false; }
+        if (!parsed) continue;
+        bool ok = roundTrips(json);
+        if (!ok) std::printf("  in %s\n", entry.path().filename().string().c_str());
+        CHECK(ok);
+        ++checked;
+    }
+    CHECK(checked >= 5);
+}
+
+TEST(fixture_round_trip) {
+    const char* fixtures[] = {
+        "null", "true", "false", "0", "-0.0", "1.5", "-2.25e-8", "1e300", "\"\"",
+        "\"short\"", "\"a string longer than the fourteen inline bytes\"",
+        "\"\\u4e2d\\u6587 \\\"quoted\\\" \\\\ \\n\"",
+        "[]", "{}", "[[],{},[{}]]",
+        R"({"a":1,"b":[true,false,null],"c":{"d":"e"}})",
+        R"({"processes":[{"id":"x","name":"web","path":"C:\\srv\\web.exe","restartCodes":[1,3221225477]}]})",
+    };
+    for (const char* f : fixtures) CHECK(roundTrips(f));
+
+    // 16 个以上的成员使用 map16 头部，65535 个以上的元素使用 array32 头部
+    std::string obj = "{";
+    for (int i = 0; i < 40; ++i) obj += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":" + std::to_string(i);
+    obj += '}';
+    CHECK(roundTrips(obj));
+    std::string arr = "[";
+    for (int i = 0; i < 70000; ++i) arr += (i ? "," : "") + std::to_string(i % 300 - 150);
+    arr += ']';
+    CHECK(roundTrips(arr));
+}
+
+// ─── 整数边界 ────────────────────────────────────────────────────────────────
+TEST(integer_boundaries) {
+    struct Edge { const char* json; const char* bytes; };
+    const Edge edges[] = {
+        { "0",                    "00" },
+        { "127",                  "7f" },                   // positive fixint 上限
+        { "128",                  "cc80" },
+        { "255",                  "ccff" },
+        { "256",                  "cd0100" },
+        { "65535",                "cdffff" },
+        { "65536",                "ce00010000" },
+        { "4294967295",           "ceffffffff" },
+        { "4294967296",           "cf0000000100000000" },
+        { "9223372036854775807",  "cf7fffffffffffffff" },   // INT64_MAX
+        { "-1",                   "ff" },
+        { "-32",                  "e0" },                   // negative fixint 下限
+        { "-33",                  "d0df" },
+        { "-128",                 "d080" },
+        { "-129",                 "d1ff7f" },
+        { "-32768",               "d18000" },
+        { "-32769",               "d2ffff7fff" },
+        { "-2147483648",          "d280000000" },
+        { "-2147483649",          "d3ffffffff7fffffff" },
+        { "-9223372036854775808", "d38000000000000000" },   // INT64_MIN
+    };
+    for (const Edge& e : edges) {
+        sj::Value v = sj::parse(e.json);
+        CHECK(v.is_int());
+        std::string bin = sj::msgpack::encode(v);
+        if (hex(bin) != e.bytes) std::printf("  %s encoded as %s, expected %s\n", e.json, hex(bin).c_str(), e.bytes);
+        CHECK_EQ(hex(bin), std::string(e.bytes));
+        sj::Value back = sj::msgpack::decode(bin);
+        CHECK(back.is_int());
+        CHECK_EQ(back.get_int64(), v.get_int64());
+        CHECK(roundTrips(e.json));
+    }
+}
+
+TEST(uint64_max) {
+    // 文本解析超出 int64 的整数得到 double；MessagePack 的 uint64 同样读为 double
+    CHECK(roundTrips("18446744073709551615"));
+    std::string bin;
+    sj::msgpack::Packer(bin).value(std::numeric_limits<unsigned long long>::max());
+    CHECK_EQ(hex(bin), std::string("cfffffffffffffffff"));
+    sj::Value v = sj::msgpack::decode(bin);
+    CHECK(v.is_number() && !v.is_int());
+    CHECK_EQ(compact(v), compact(sj::parse("18446744073709551615")));
+
+    sj::msgpack::Unpacker u(bin);
+    CHECK(u.next() == sj::Event::Number);
+    CHECK(!u.is_integer());
+    CHECK_EQ(u.integer(), std::numeric_limits<int64_t>::max());   // 饱和而非未定义行为
+}
+
+// ─── 结构体 ──────────────────────────────────────────────────────────────────
+TEST(struct_decode_matches_text) {
+    const char* json =
+        R"({"id":"a","big":-9223372036854775808,"code":4294967295,"n":-2147483648,"d":0.1,"on":true,)"
+        R"("codes":[0,127,128,65536,4294967295]})";
+    Item fromText, fromBin;
+    sj::FieldMask mt = sj::decode(json, fromText);
+    std::string bin;
+    sj::msgpack::Packer pk(bin);
+    sj::msgpack::encode(pk, fromText);
+    sj::FieldMask mb = sj::msgpack::decode(bin, fromBin);
+    CHECK_EQ(mt, mb);
+    CHECK_EQ(sj::encode(fromText), sj::encode(fromBin));
+    CHECK_EQ(fromBin.big, std::numeric_limits<int64_t>::min());
+    CHECK_EQ(fromBin.code, 4294967295u);
+
+    // 超出成员范围的值在两条路径上都按类型不符处理
+    Item a, b;
+    const char* wide = R"({"code":4294967296,"n":2147483648,"big":1e19})";
+    sj::FieldMask wa = sj::decode(wide, a);
+    sj::FieldMask wb = sj::msgpack::decode(sj::msgpack::encode(sj::parse(wide)), b);
+    CHECK_EQ(wa, (sj::FieldMask)0);
+    CHECK_EQ(wb, (sj::FieldMask)0);
+}
+
+// 按位置编码：往返结果与按键编码相同，结构不符时抛出而不是静默跳过
+TEST(struct_tuple_round_trip) {
+    Item in;
+    sj::decode(R"({"id":"a","big":-5,"code":7,"n":-1,"d":0.5,"on":true,"codes":[1,300]})", in);
+    std::string bin;
+    sj::msgpack::Packer pk(bin);
+    sj::msgpack::encodeTuple(pk, in);
+    Item out;
+    sj::msgpack::decodeTuple(bin, out);
+    CHECK_EQ(sj::encode(out), sj::encode(in));
+
+    bool threw = false;
+    try {
+        Item bad;
+        sj::msgpack::decodeTuple(sj::msgpack::encode(sj::parse("[1,2]")), bad);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() { return test::runTests(); }
@@ -0,0 +1,92 @@
+// posix_backend_test.cpp  -  PosixProcessBackend 的退出码与回收
+#include "TestUtil.h"
+#include "PosixProcessBackend.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace {
+
+// 启动 sh -c script 并等待退出回调，返回上报的退出码；超时返回 -1。
+// holdFd >= 0 时在注册回调之后才关闭它，脚本可借此阻塞到回调就绪
+int64_t exitCodeOf(PosixProcessBackend& backend, const std::string& script, int holdFd = -1) {
+    SpawnSpec spec;
+    spec.path = "/bin/sh";
+    spec.args = "-c '" + script + "'";
+    std::string error;
+    std::unique_ptr<IProcess> proc = backend.spawn(spec, error);
+    if (!proc) {
+        std::printf("  spawn failed: %s\n", error.c_str());
+        if (holdFd >= 0) close(holdFd);
+        return -1;
+    }
+    std::mutex m;
+    std::condition_variable cv;
+    int64_t code = -1;
+    proc->waitForExit([&](uint32_t c) {
+        std::lock_guard<std::mutex> lock(m);
+        code = c;
+        cv.notify_all();
+    });
+    if (holdFd >= 0) close(holdFd);
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait_for(lock, std::chrono::seconds(5), [&] { return code >= 0; });
+    int64_t result = code;
+    lock.unlock();
+    proc.reset();
+    return result;
+}
+
+} // namespace
+
+TEST(exit_code_is_reported) {
+    PosixProcessBackend backend;
+    CHECK_EQ(exitCodeOf(backend, "exit 0"), 0);
+    CHECK_EQ(exitCodeOf(backend, "exit 3"), 3);
+}
+
+TEST(killed_by_signal_reports_128_plus_signal) {
+    PosixProcessBackend backend;
+    CHECK_EQ(exitCodeOf(backend, "kill -9 $$"), 128 + SIGKILL);
+}
+
+TEST(unreaped_exit_is_not_reported_as_success) {
+    // SIGCHLD 被忽略时内核自动回收子进程，waitpid 以 ECHILD 失败，拿不到退出状态
+    struct sigaction old = {};
+    struct sigaction ign = {};
+    ign.sa_handler = SIG_IGN;
+    sigaction(SIGCHLD, &ign, &old);
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);   // 子进程不能持有写端，否则读不到 EOF
+    {
+        // 子进程读管道直到父进程注册回调后关闭写端，保证 pidfd_open 时进程仍在运行
+        PosixProcessBackend backend;
+        std::string script = "read x <&" + std::to_string(fds[0]) + "; exit 0";
+        CHECK_EQ(exitCodeOf(backend, script, fds[1]), 255);
+    }
+    close(fds[0]);
+    sigaction(SIGCHLD, &old, nullptr);
+}
+
+TEST(exit_before_pidfd_open_is_not_reported_as_success) {
+    // 进程可能在 pidfd_open 之前就被内核回收：spawn 仍须成功，并报告未知退出码
+    struct sigaction old = {};
+    struct sigaction ign = {};
+    ign.sa_handler = SIG_IGN;
+    sigaction(SIGCHLD, &ign, &old);
+    {
+        PosixProcessBackend backend;
+        for (int i = 0; i < 20; ++i) CHECK_EQ(exitCodeOf(backend, "exit 0"), 255);
+    }
+    sigaction(SIGCHLD, &old, nullptr);
+}
+
+int main() { return test::runTests(); }
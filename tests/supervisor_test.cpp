@@ -0,0 +1,469 @@
+// supervisor_test.cpp  -  Supervisor 的守护、热重载与依赖处理，进程由 FakeProcessBackend 模拟
+#include "TestUtil.h"
+#include "FakeBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using test::FakeHost;
+using test::FakeProcessBackend;
+using test::fakeProcess;
+using test::waitFor;
+
+namespace {
+
+// 后端先于 Supervisor 构造、后于它析构
+struct Fixture {
+    FakeProcessBackend backend;
+    FakeHost           host;
+    Supervisor         sup{ backend, host };
+    Fixture() { host.sup = &sup; }
+};
+
+bool statusIs(Supervisor& sup, const std::string& id, ProcStatus s) {
+    return waitFor([&] { return sup.getStatus(id) == s; });
+}
+
+using Clock = std::chrono::steady_clock;
+
+// 崩溃循环模拟：记录每个条目各次启动的时刻，exitCode(id, n) 决定第 n 次（从 0 起）启动后
+// 立即以哪个退出码退出，返回 -1 表示保持运行
+struct CrashLoop {
+    std::function<int64_t(const std::string&, size_t)> exitCode;
+
+    void attach(FakeProcessBackend& backend) {
+        backend.exitOnSpawn = [this](const SpawnSpec& spec) {
+            std::string id = spec.path.substr(spec.path.rfind('/') + 1);
+            size_t n;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& times = m_spawns[id];
+                times.push_back(Clock::now());
+                n = times.size() - 1;
+            }
+            return exitCode(id, n);
+        };
+    }
+
+    std::vector<Clock::time_point> spawns(const std::string& id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spawns[id];
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<std::string, std::vector<Clock::time_point>> m_spawns;
+};
+
+std::vector<ProcessConfig> crashingFleet(size_t n, const ProcessConfig& tmpl) {
+    std::vector<ProcessConfig> procs;
+    for (size_t i = 0; i < n; ++i) {
+        ProcessConfig p = tmpl;
+        p.id = p.name = "p" + std::to_string(i);
+        p.path = "/fake/" + p.id;
+        procs.push_back(std::move(p));
+    }
+    return procs;
+}
+
+int64_t msBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+}
+
+// 全部停止并等到都进入 Stopped：退出由后端线程异步送达，须在 Supervisor 析构前处理完
+bool stopAllAndWait(Fixture& f) {
+    f.sup.stopAll();
+    ConfigPtr snap = f.host.config();
+    return waitFor([&] {
+        for (const auto& p : snap->config.processes)
+            if (f.sup.getStatus(p.id) != ProcStatus::Stopped) return false;
+        return true;
+    });
+}
+
+// 记录各条目被创建进程的先后顺序，进程保持运行
+struct SpawnOrder {
+    void attach(FakeProcessBackend& backend) {
+        backend.exitOnSpawn = [this](const SpawnSpec& spec) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ids.push_back(spec.path.substr(spec.path.rfind('/') + 1));
+            return (int64_t)-1;
+        };
+    }
+
+    // id 第一次启动的序号，未启动时为 -1
+    int at(const std::string& id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find(m_ids.begin(), m_ids.end(), id);
+        return it == m_ids.end() ? -1 : (int)(it - m_ids.begin());
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::string> m_ids;
+};
+
+ProcessConfig dependent(const std::string& id, std::vector<std::string> deps) {
+    ProcessConfig p = fakeProcess(id);
+    p.dependsOn = std::move(deps);
+    return p;
+}
+
+} // namespace
+
+// 50 个进程启动即崩溃：每次重启的间隔不短于退避下限并逐次翻倍，抖动使同一批进程错开重启
+TEST(crash_loop_backs_off_with_jitter) {
+    Fixture f;
+    CrashLoop loop;
+    loop.exitCode = [](const std::string&, size_t) { return 1; };
+    loop.attach(f.backend);
+    ProcessConfig tmpl = fakeProcess("t");
+    tmpl.guardEnabled = true;
+    tmpl.guardDelaySeconds = 1;
+    tmpl.maxRestarts = 0;
+    const size_t n = 50;
+    f.host.keepLog = false;
+    f.host.setConfig(crashingFleet(n, tmpl));
+    f.sup.startAll();
+
+    // 第 3 次启动约在 2.4 ~ 3.7 秒
+    CHECK(waitFor([&] { return f.backend.spawned() >= 3 * n; }, std::chrono::milliseconds(8000)));
+    CHECK(stopAllAndWait(f));
+
+    int64_t minFirst = INT64_MAX, maxFirst = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto at = loop.spawns("p" + std::to_string(i));
+        CHECK(at.size() >= 3);
+        if (at.size() < 3) continue;
+        int64_t first  = msBetween(at[0], at[1]);   // 1 秒 × 0.8 ~ 1.2
+        int64_t second = msBetween(at[1], at[2]);   // 2 秒 × 0.8 ~ 1.2
+        CHECK(first >= 800);
+        CHECK(second >= 1600);
+        CHECK(second > first);
+        minFirst = std::min(minFirst, first);
+        maxFirst = std::max(maxFirst, first);
+    }
+    CHECK(maxFirst - minFirst >= 100);   // 不在同一个 tick 重启
+}
+
+// 50 个进程频繁崩溃：达到 maxRestarts 后全部停止守护并标记为启动失败，不再创建进程
+TEST(crash_breaker_parks_whole_fleet) {
+    Fixture f;
+    CrashLoop loop;
+    loop.exitCode = [](const std::string&, size_t) { return 1; };
+    loop.attach(f.backend);
+    ProcessConfig tmpl = fakeProcess("t");
+    tmpl.guardEnabled = true;
+    tmpl.guardDelaySeconds = 0;
+    tmpl.backoffMaxSeconds = 1;
+    tmpl.maxRestarts = 3;
+    tmpl.restartWindowSeconds = 60;
+    const size_t n = 50;
+    f.host.keepLog = false;
+    f.host.setConfig(crashingFleet(n, tmpl));
+    f.sup.startAll();
+
+    // 重启延迟 0、1、1 秒，第 4 次崩溃时判定
+    for (size_t i = 0; i < n; ++i) CHECK(statusIs(f.sup, "p" + std::to_string(i), ProcStatus::Failed));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CHECK_EQ(f.backend.spawned(), 4 * n);
+    RestartState st = f.sup.getRestartState("p0");
+    CHECK(st.tripped);
+    CHECK_EQ(st.recent, 3);
+}
+
+// restartOn 按退出码判断：on-failure 不重启正常退出，codes 只重启列出的退出码
+TEST(restart_rules_follow_exit_codes) {
+    Fixture f;
+    CrashLoop loop;
+    loop.exitCode = [](const std::string& id, size_t n) -> int64_t {
+        if (n > 0) return -1;
+        return id == "a" ? 0 : id == "b" ? 3221225477 : 1;
+    };
+    loop.attach(f.backend);
+    ProcessConfig a = fakeProcess("a"), b = fakeProcess("b"), c = fakeProcess("c"), d = fakeProcess("d");
+    for (ProcessConfig* p : { &a, &b, &c, &d }) {
+        p->guardEnabled = true;
+        p->guardDelaySeconds = 0;
+    }
+    a.restartOn = "on-failure";
+    b.restartOn = c.restartOn = "codes";
+    b.restartCodes = c.restartCodes = { 3221225477u };   // 0xC0000005
+    d.restartOn = "never";
+    f.host.setConfig({ a, b, c, d });
+    f.sup.startAll();
+
+    CHECK(statusIs(f.sup, "a", ProcStatus::Stopped));
+    CHECK(statusIs(f.sup, "c", ProcStatus::Stopped));
+    CHECK(statusIs(f.sup, "d", ProcStatus::Stopped));
+    CHECK(waitFor([&] { return loop.spawns("b").size() == 2; }));
+    CHECK(statusIs(f.sup, "b", ProcStatus::Running));
+    CHECK_EQ(loop.spawns("a").size(), (size_t)1);
+    CHECK_EQ(loop.spawns("c").size(), (size_t)1);
+    CHECK_EQ(loop.spawns("d").size(), (size_t)1);
+    CHECK(f.host.logged("不在守护重启规则内"));
+    CHECK(stopAllAndWait(f));
+}
+
+// 连续运行超过 backoffMaxSeconds 视为已恢复，下一次崩溃的退避从头计算
+TEST(long_run_resets_crash_streak) {
+    Fixture f;
+    CrashLoop loop;
+    loop.exitCode = [](const std::string&, size_t n) -> int64_t { return n < 2 ? 1 : -1; };
+    loop.attach(f.backend);
+    ProcessConfig p = fakeProcess("a");
+    p.guardEnabled = true;
+    p.guardDelaySeconds = 0;
+    p.backoffMaxSeconds = 1;
+    f.host.setConfig({ p });
+    f.sup.startAll();
+
+    // 立即重启一次，再等约 1 秒重启后保持运行
+    CHECK(waitFor([&] { return loop.spawns("a").size() == 3; }));
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+    CHECK_EQ(f.sup.getRestartState("a").attempt, 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    f.backend.exit(f.sup.getPid("a"), 1);
+    CHECK(waitFor([&] { return loop.spawns("a").size() == 4; }, std::chrono::milliseconds(500)));
+    RestartState st = f.sup.getRestartState("a");
+    CHECK_EQ(st.attempt, 1);
+    CHECK_EQ(st.delayMs, (int64_t)0);
+    CHECK(stopAllAndWait(f));
+}
+
+TEST(guard_disabled_while_restarting_cancels_restart) {
+    Fixture f;
+    ProcessConfig p = fakeProcess("a");
+    p.guardEnabled = true;
+    p.guardDelaySeconds = 1;
+    f.host.setConfig({ p });
+    f.sup.startAll();
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+
+    f.backend.exit(f.sup.getPid("a"), 1);
+    CHECK(statusIs(f.sup, "a", ProcStatus::Restarting));
+
+    // 等待重启期间关闭守护（界面修改或热重载发布的新版本）
+    p.guardEnabled = false;
+    f.host.setConfig({ p });
+    ConfigDiff none;
+    f.sup.applyConfigDiff(none);
+
+    CHECK(statusIs(f.sup, "a", ProcStatus::Stopped));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    CHECK(f.sup.getStatus("a") == ProcStatus::Stopped);
+    CHECK_EQ(f.backend.spawned(), (size_t)1);
+    CHECK(f.host.logged("守护已关闭"));
+}
+
+TEST(restart_policy_edit_applies_on_next_exit) {
+    Fixture f;
+    ProcessConfig p = fakeProcess("a");
+    p.guardEnabled = true;
+    p.guardDelaySeconds = 0;
+    f.host.setConfig({ p });
+    f.sup.startAll();
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+
+    // 运行中改为仅失败时重启：之后的正常退出不再重启
+    p.restartOn = "on-failure";
+    f.host.setConfig({ p });
+    f.backend.exit(f.sup.getPid("a"), 0);
+    CHECK(statusIs(f.sup, "a", ProcStatus::Stopped));
+    CHECK_EQ(f.backend.spawned(), (size_t)1);
+}
+
+TEST(enabled_edit_does_not_stop_running_process) {
+    Fixture f;
+    ProcessConfig p = fakeProcess("a");
+    f.host.setConfig({ p });
+    f.sup.startAll();
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+
+    p.enabled = false;
+    f.host.setConfig({ p });
+    ConfigDiff none;
+    f.sup.applyConfigDiff(none);
+    CHECK(f.sup.getStatus("a") == ProcStatus::Running);
+    CHECK_EQ(f.backend.alive(), (size_t)1);
+    f.sup.stopAll();
+    CHECK(statusIs(f.sup, "a", ProcStatus::Stopped));
+}
+
+// c 依赖 b，b 依赖 a：逐个等前一个进入运行状态后才启动
+TEST(dependency_chain_starts_in_order) {
+    Fixture f;
+    SpawnOrder order;
+    order.attach(f.backend);
+    f.host.setConfig({ dependent("c", { "b" }), dependent("b", { "a" }), fakeProcess("a") });
+    f.sup.startAll();
+
+    CHECK(statusIs(f.sup, "c", ProcStatus::Running));
+    CHECK_EQ(order.at("a"), 0);
+    CHECK_EQ(order.at("b"), 1);
+    CHECK_EQ(order.at("c"), 2);
+    CHECK(f.host.logged("按依赖分 3 层"));
+    CHECK(stopAllAndWait(f));
+}
+
+// b、c 都依赖 a，d 同时依赖 b 和 c：d 在两者都运行后只启动一次
+TEST(dependency_diamond_starts_join_once) {
+    Fixture f;
+    SpawnOrder order;
+    order.attach(f.backend);
+    f.host.setConfig({ dependent("d", { "b", "c" }), dependent("b", { "a" }), dependent("c", { "a" }),
+                       fakeProcess("a") });
+    f.sup.startAll();
+
+    CHECK(statusIs(f.sup, "d", ProcStatus::Running));
+    CHECK_EQ(order.at("a"), 0);
+    CHECK(order.at("b") > 0 && order.at("c") > 0);
+    CHECK_EQ(order.at("d"), 3);
+    CHECK_EQ(f.backend.spawned(), (size_t)4);
+    CHECK(stopAllAndWait(f));
+}
+
+// x、y 互相依赖，z 依赖自身：环上的条目全部标记为启动失败，不创建任何进程
+TEST(dependency_cycles_fail_without_spawning) {
+    Fixture f;
+    f.host.setConfig({ dependent("x", { "y" }), dependent("y", { "x" }), dependent("z", { "z" }) });
+    f.sup.startAll();
+
+    for (const char* id : { "x", "y", "z" }) CHECK(statusIs(f.sup, id, ProcStatus::Failed));
+    CHECK(f.host.logged("无法启动：存在循环依赖"));
+    CHECK(f.host.logged("循环依赖：x → y → x"));   // 日志只列出找到的第一个环
+    CHECK_EQ(f.backend.spawned(), (size_t)0);
+}
+
+// a 未通过配置校验而被跳过，依赖它的 b 随之失败；c 依赖的条目不存在，忽略该依赖照常启动
+TEST(skipped_and_missing_dependencies) {
+    Fixture f;
+    ProcessConfig a = fakeProcess("a");
+    auto check = std::make_shared<ConfigValidation>();
+    check->issues["a"] = ConfigIssue{ a.path, "id 重复", true };
+    f.host.setValidation(check);
+    f.host.setConfig({ a, dependent("b", { "a" }), dependent("c", { "ghost" }) });
+    f.sup.startAll();
+
+    CHECK(statusIs(f.sup, "c", ProcStatus::Running));
+    CHECK(statusIs(f.sup, "a", ProcStatus::Failed));
+    CHECK(statusIs(f.sup, "b", ProcStatus::Failed));
+    CHECK(f.host.logged("依赖的进程 a 配置校验未通过"));
+    CHECK(f.host.logged("依赖的进程 ghost 不存在，已忽略"));
+    CHECK_EQ(f.backend.spawned(), (size_t)1);
+    CHECK(stopAllAndWait(f));
+}
+
+TEST(entry_removed_while_queued_fails_dependents) {
+    Fixture f;
+    ProcessConfig a = fakeProcess("a");
+    a.delaySeconds = 1;
+    ProcessConfig b = fakeProcess("b");
+    b.dependsOn = { "a" };
+    f.host.setConfig({ a, b });
+    f.sup.startProcess("b");
+    CHECK(f.sup.getStatus("a") == ProcStatus::Starting);
+    CHECK(f.sup.getStatus("b") == ProcStatus::Starting);
+
+    // 延迟期间 a 从配置中删除：到期后启动失败，等它的 b 随之失败，而不是一直停在“启动中”
+    f.host.setConfig({ b });
+    CHECK(statusIs(f.sup, "a", ProcStatus::Failed));
+    CHECK(statusIs(f.sup, "b", ProcStatus::Failed));
+    CHECK_EQ(f.backend.spawned(), (size_t)0);
+}
+
+TEST(breaker_trip_fails_dependents) {
+    Fixture f;
+    ProcessConfig a = fakeProcess("a");
+    a.guardEnabled = true;
+    a.guardDelaySeconds = 1;
+    a.maxRestarts = 1;
+    a.restartWindowSeconds = 60;
+    ProcessConfig b = fakeProcess("b");
+    b.dependsOn = { "a" };
+    f.host.setConfig({ a, b });
+
+    f.sup.startProcess("a");
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+    f.backend.exit(f.sup.getPid("a"), 1);   // 第 1 次守护重启，等待 1 秒
+    CHECK(statusIs(f.sup, "a", ProcStatus::Restarting));
+    f.sup.startProcess("b");                // b 等 a 重新运行
+    CHECK(f.sup.getStatus("b") == ProcStatus::Starting);
+
+    // a 重新启动后、放行 b 之前立即再次崩溃，触发频繁崩溃判定
+    bool injected = false;
+    f.host.onStatus = [&](const std::string& id, ProcStatus s) {
+        if (id != "a" || s != ProcStatus::Running || injected) return;
+        injected = true;
+        f.backend.exit(f.sup.getPid("a"), 1);
+        waitFor([&] { return f.sup.getStatus("a") == ProcStatus::Failed; });
+    };
+    CHECK(statusIs(f.sup, "a", ProcStatus::Failed));
+    CHECK(f.sup.getRestartState("a").tripped);
+    CHECK(statusIs(f.sup, "b", ProcStatus::Failed));
+    CHECK_EQ(f.backend.spawned(), (size_t)2);
+    f.host.onStatus = nullptr;
+}
+
+TEST(backoff_doubles_up_to_cap) {
+    ProcessConfig p = fakeProcess("a");
+    p.guardDelaySeconds = 1;
+    p.backoffMaxSeconds = 60;
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 1), (int64_t)1000);
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 2), (int64_t)2000);
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 6), (int64_t)32000);
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 7), (int64_t)60000);
+    CHECK_EQ(Supervisor::backoffBaseMs(p, INT_MAX), (int64_t)60000);
+
+    p.guardDelaySeconds = 0;
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 1), (int64_t)0);
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 2), (int64_t)2000);
+}
+
+TEST(backoff_saturates_for_huge_settings) {
+    // 秒数取到 int 上限：左移与毫秒换算都不能溢出
+    ProcessConfig p = fakeProcess("a");
+    p.guardDelaySeconds = INT_MAX;
+    p.backoffMaxSeconds = INT_MAX;
+    const int64_t cap = (int64_t)INT_MAX * 1000;
+    CHECK_EQ(Supervisor::backoffBaseMs(p, 1), cap);
+    for (int streak : { 2, 31, 32, 63, 64, 1000, INT_MAX }) CHECK_EQ(Supervisor::backoffBaseMs(p, streak), cap);
+
+    p.guardDelaySeconds = 1;
+    int64_t prev = 0;
+    for (int streak = 1; streak < 80; ++streak) {
+        int64_t d = Supervisor::backoffBaseMs(p, streak);
+        CHECK(d >= prev && d <= cap);
+        prev = d;
+    }
+    CHECK_EQ(prev, cap);
+}
+
+TEST(long_backoff_is_not_truncated) {
+    // 约 34.7 天，超过 int 毫秒数能表示的 24.8 天
+    Fixture f;
+    ProcessConfig p = fakeProcess("a");
+    p.guardEnabled = true;
+    p.guardDelaySeconds = 3000000;
+    f.host.setConfig({ p });
+    f.sup.startAll();
+    CHECK(statusIs(f.sup, "a", ProcStatus::Running));
+    f.backend.exit(f.sup.getPid("a"), 1);
+    CHECK(statusIs(f.sup, "a", ProcStatus::Restarting));
+
+    RestartState st = f.sup.getRestartState("a");
+    CHECK(st.delayMs >= (int64_t)2400000000 && st.delayMs <= (int64_t)3000000000);
+    CHECK(st.dueInMs > (int64_t)INT_MAX && st.dueInMs <= st.delayMs);
+    CHECK(sj::encode(st).find("\"delayMs\":" + std::to_string(st.delayMs)) != std::string::npos);
+    f.sup.stopProcess("a");
+    CHECK(statusIs(f.sup, "a", ProcStatus::Stopped));
+}
+
+int main() { return test::runTests(); }
@@ -0,0 +1,111 @@
+// timer_wheel_test.cpp  -  TimerWheel：取消、过期 id、各层下放的到期时刻与回调中再次 schedule
+#include "TestUtil.h"
+#include "FakeBackend.h"
+#include "TimerWheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using test::waitFor;
+using std::chrono::milliseconds;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t msSince(Clock::time_point t0) {
+    return std::chrono::duration_cast<milliseconds>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+TEST(cancel_before_fire_drops_callback) {
+    TimerWheel wheel(milliseconds(1));
+    std::atomic<int> fired{0};
+    TimerWheel::TimerId id = wheel.schedule(milliseconds(50), [&](TimerWheel::TimerId) { ++fired; });
+    CHECK(id != 0);
+    CHECK_EQ(wheel.pending(), (size_t)1);
+    CHECK(wheel.cancel(id));
+    CHECK_EQ(wheel.pending(), (size_t)0);
+    std::this_thread::sleep_for(milliseconds(120));
+    CHECK_EQ(fired.load(), 0);
+}
+
+// 已到期或已取消的 id 失效；节点复用后旧 id 也不会取消新的定时器
+TEST(stale_id_cancel_returns_false) {
+    TimerWheel wheel(milliseconds(1));
+    std::atomic<int> fired{0};
+    CHECK(!wheel.cancel(0));
+
+    TimerWheel::TimerId done = wheel.schedule(milliseconds(0), [&](TimerWheel::TimerId) { ++fired; });
+    CHECK(waitFor([&] { return fired.load() == 1; }));
+    CHECK(!wheel.cancel(done));
+
+    TimerWheel::TimerId cancelled = wheel.schedule(milliseconds(1000), [&](TimerWheel::TimerId) { ++fired; });
+    CHECK(wheel.cancel(cancelled));
+    CHECK(!wheel.cancel(cancelled));
+
+    TimerWheel::TimerId reused = wheel.schedule(milliseconds(30), [&](TimerWheel::TimerId) { ++fired; });
+    CHECK(reused != done && reused != cancelled);
+    CHECK(!wheel.cancel(done));
+    CHECK(!wheel.cancel(cancelled));
+    CHECK_EQ(wheel.pending(), (size_t)1);
+    CHECK(waitFor([&] { return fired.load() == 2; }));
+}
+
+// tick 为 10 微秒时第 1~3 层分别从约 0.64 毫秒、41 毫秒、2.6 秒开始。
+// 各层的定时器都不早于预定时刻、按到期先后回调；先等几毫秒，使挂入时低层不在圈首
+TEST(cascaded_timers_fire_in_order_and_not_early) {
+    TimerWheel wheel(std::chrono::microseconds(10));
+    std::this_thread::sleep_for(milliseconds(3));
+
+    const std::vector<int> delays = { 0, 1, 5, 30, 45, 100, 700, 1500, 2700, 3000 };
+    struct Fired { size_t index; int64_t atMs; };
+    std::mutex mutex;
+    std::vector<Fired> fired;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.schedule(milliseconds(delays[i]), [&, i](TimerWheel::TimerId) {
+            std::lock_guard<std::mutex> lock(mutex);
+            fired.push_back({ i, msSince(t0) });
+        });
+    }
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return fired.size() == delays.size();
+    }, milliseconds(6000)));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK_EQ(fired.size(), delays.size());
+    for (size_t k = 0; k < fired.size(); ++k) {
+        int delay = delays[fired[k].index];
+        if (fired[k].index != k || fired[k].atMs < delay || fired[k].atMs > delay + 200)
+            std::printf("  #%zu: delay %d ms fired at %lld ms\n", k, delay, (long long)fired[k].atMs);
+        CHECK_EQ(fired[k].index, k);
+        CHECK(fired[k].atMs >= delay);
+        CHECK(fired[k].atMs <= delay + 200);
+    }
+    CHECK_EQ(wheel.pending(), (size_t)0);
+}
+
+// 回调执行时不持有时间轮的锁：可以再挂新的定时器，取消自身返回 false
+TEST(schedule_from_callback) {
+    TimerWheel wheel(milliseconds(1));
+    std::atomic<int> rounds{0};
+    std::atomic<bool> selfCancel{true};
+    std::function<void(TimerWheel::TimerId)> again = [&](TimerWheel::TimerId self) {
+        if (wheel.cancel(self)) selfCancel = false;
+        if (++rounds < 5) wheel.schedule(milliseconds(5), again);
+    };
+    Clock::time_point t0 = Clock::now();
+    wheel.schedule(milliseconds(5), again);
+    CHECK(waitFor([&] { return rounds.load() == 5; }));
+    CHECK(msSince(t0) >= 25);
+    CHECK(selfCancel.load());
+    CHECK(waitFor([&] { return wheel.pending() == 0; }));
+}
+
+int main() { return test::runTests(); }